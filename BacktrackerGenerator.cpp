@@ -0,0 +1,62 @@
+#include "BacktrackerGenerator.h"
+#include "VisitedBitboard.h"
+
+std::string BacktrackerGenerator::getName()
+{
+	return "backtracker";
+}
+
+void BacktrackerGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	const size_t numCells = sizeX * sizeY;
+	//Cells are read directly, and written through the maze so that changes are published.
+	//Visits are tracked separately at one bit per cell, which keeps neighbour tests in cache
+	const uint8_t* cells = maze->getMaze();
+	VisitedBitboard visited(sizeX, sizeY);
+
+	//The stack holds the direction taken into each cell on the current path (0 to 3 for N, E, S & W),
+	//which is all that is needed to backtrack. Packed at two bits per step it can be allocated once
+	//for the deepest possible path, so the loop below never touches the heap
+	std::vector<uint8_t> routeLog((numCells + 3) / 4);
+	size_t routeDepth = 0;
+	//Choose a random start point
+	size_t currentX = random.nextBelow(sizeX);
+	size_t currentY = random.nextBelow(sizeY);
+	maze->setCurrentLocation(currentX, currentY);
+	maze->addCellLocation(std::pair<size_t, size_t>(currentX, currentY));
+	maze->setCell(currentX, currentY, CELL_VISITED);
+	visited.setVisited(currentX, currentY);
+	size_t numVisited = 1;
+
+	while (numVisited < numCells)
+	{
+		//Try to find an unvisited neighbour, checking N, E, S & W at once
+		uint8_t possibleRoutes = visited.getUnvisitedNeighbours(currentX, currentY);
+		if (possibleRoutes == 0)
+		{
+			//Backtrack by stepping back against the direction this cell was entered from
+			routeDepth--;
+			uint8_t enteredFrom = (routeLog[routeDepth >> 2] >> ((routeDepth & 3) * 2)) & 0x03;
+			currentX -= DIRECTION_X[enteredFrom];
+			currentY -= DIRECTION_Y[enteredFrom];
+			maze->setCurrentLocation(currentX, currentY);
+			continue;
+		}
+
+		//There is a viable cell, set the path and move into it
+		uint8_t chosenRoute = chooseRoute(possibleRoutes, random);
+		maze->setCell(currentX, currentY, cells[maze->getCellIndex(currentX, currentY)] | (1 << chosenRoute));
+		currentX += DIRECTION_X[chosenRoute];
+		currentY += DIRECTION_Y[chosenRoute];
+		uint8_t& routeByte = routeLog[routeDepth >> 2];
+		routeByte = (routeByte & ~(0x03 << ((routeDepth & 3) * 2))) | (chosenRoute << ((routeDepth & 3) * 2));
+		routeDepth++;
+		maze->addCellLocation(std::pair<size_t, size_t>(currentX, currentY));
+		maze->setCell(currentX, currentY, CELL_VISITED);
+		visited.setVisited(currentX, currentY);
+		numVisited++;
+		step(maze, currentX, currentY);
+	}
+}
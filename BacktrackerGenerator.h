@@ -0,0 +1,16 @@
+#ifndef BACKTRACKER_GENERATOR_H
+#define BACKTRACKER_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Recursive backtracker: a random walk which backs up along its own path whenever it is boxed in.
+//Gives long, winding corridors with few dead ends
+class BacktrackerGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
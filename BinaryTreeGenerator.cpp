@@ -0,0 +1,25 @@
+#include "BinaryTreeGenerator.h"
+
+std::string BinaryTreeGenerator::getName()
+{
+	return "binarytree";
+}
+
+void BinaryTreeGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			//Only the top left cell has neither a north nor a west neighbour
+			uint8_t routes = getNeighbourMask(x, y, sizeX, sizeY) & (CELL_PATH_N | CELL_PATH_W);
+			if (routes != 0)
+			{
+				carvePassage(maze, x, y, chooseRoute(routes, random));
+				step(maze, x, y);
+			}
+		}
+	}
+}
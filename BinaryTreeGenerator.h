@@ -0,0 +1,16 @@
+#ifndef BINARY_TREE_GENERATOR_H
+#define BINARY_TREE_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Binary tree: every cell opens a passage either north or west. Very fast and needs no memory,
+//but the north and west edges are always open corridors
+class BinaryTreeGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "CompactMaze.h"
+
+CompactMaze::CompactMaze(size_t sizeX, size_t sizeY)
+{
+	CompactMaze::sizeX = sizeX;
+	CompactMaze::sizeY = sizeY;
+	CompactMaze::wordsPerRow = (sizeX + 63) / 64;
+	CompactMaze::startCell = std::pair<size_t, size_t>(0, 0);
+	CompactMaze::winCell = std::pair<size_t, size_t>(sizeX - 1, sizeY - 1);
+
+	//Every wall starts standing, with the padding past the end of each row left clear
+	std::vector<uint64_t> row(wordsPerRow, ~0ULL);
+	if (sizeX % 64 != 0)
+	{
+		row[wordsPerRow - 1] = (1ULL << (sizeX % 64)) - 1;
+	}
+	eastWalls.reserve(wordsPerRow * sizeY);
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		eastWalls.insert(eastWalls.end(), row.begin(), row.end());
+	}
+	southWalls = eastWalls;
+}
+
+CompactMaze::CompactMaze(Maze* maze)
+	: CompactMaze(maze->getSizeX(), maze->getSizeY())
+{
+	std::vector<uint8_t> rowBuffer(sizeX);
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		writeRow(y, maze->getRow(y, rowBuffer.data()));
+	}
+	startCell = maze->getStartCell();
+	winCell = maze->getWinCell();
+}
+
+size_t CompactMaze::getWordIndex(size_t x, size_t y)
+{
+	return y * wordsPerRow + x / 64;
+}
+
+uint64_t CompactMaze::getBit(size_t x)
+{
+	return 1ULL << (x % 64);
+}
+
+bool CompactMaze::writeRow(size_t y, const uint8_t* cells)
+{
+	for (size_t x = 0; x < sizeX; x++)
+	{
+		uint8_t cell = cells[x];
+		if ((cell & CELL_PATH_E) && x < sizeX - 1)
+		{
+			eastWalls[getWordIndex(x, y)] &= ~getBit(x);
+		}
+		if ((cell & CELL_PATH_S) && y < sizeY - 1)
+		{
+			southWalls[getWordIndex(x, y)] &= ~getBit(x);
+		}
+		//Passages recorded on this side of the row above or the cell to the west belong to the neighbour's wall
+		if ((cell & CELL_PATH_N) && y > 0)
+		{
+			southWalls[getWordIndex(x, y - 1)] &= ~getBit(x);
+		}
+		if ((cell & CELL_PATH_W) && x > 0)
+		{
+			eastWalls[getWordIndex(x - 1, y)] &= ~getBit(x - 1);
+		}
+	}
+	return true;
+}
+
+void CompactMaze::setStartCell(size_t x, size_t y)
+{
+	CompactMaze::startCell = std::pair<size_t, size_t>(x, y);
+}
+
+void CompactMaze::setWinCell(size_t x, size_t y)
+{
+	CompactMaze::winCell = std::pair<size_t, size_t>(x, y);
+}
+
+uint8_t CompactMaze::getCell(size_t x, size_t y)
+{
+	return (uint8_t)((~getWalls(x, y) & 0x0F) | CELL_VISITED);
+}
+
+uint8_t CompactMaze::getWalls(size_t x, size_t y)
+{
+	uint8_t walls = CELL_NULL;
+	walls |= (y == 0 || (southWalls[getWordIndex(x, y - 1)] & getBit(x))) ? CELL_PATH_N : 0;
+	walls |= (eastWalls[getWordIndex(x, y)] & getBit(x)) ? CELL_PATH_E : 0;
+	walls |= (southWalls[getWordIndex(x, y)] & getBit(x)) ? CELL_PATH_S : 0;
+	walls |= (x == 0 || (eastWalls[getWordIndex(x - 1, y)] & getBit(x - 1))) ? CELL_PATH_W : 0;
+	return walls;
+}
+
+bool CompactMaze::hasWall(size_t x, size_t y, uint8_t direction)
+{
+	return (getWalls(x, y) & direction) != 0;
+}
+
+void CompactMaze::getRow(size_t y, uint8_t* cells)
+{
+	for (size_t x = 0; x < sizeX; x++)
+	{
+		cells[x] = getCell(x, y);
+	}
+}
+
+const uint64_t* CompactMaze::getEastWalls(size_t y)
+{
+	return eastWalls.data() + y * wordsPerRow;
+}
+
+const uint64_t* CompactMaze::getSouthWalls(size_t y)
+{
+	return southWalls.data() + y * wordsPerRow;
+}
+
+size_t CompactMaze::getWordsPerRow()
+{
+	return wordsPerRow;
+}
+
+size_t CompactMaze::getSizeX()
+{
+	return CompactMaze::sizeX;
+}
+
+size_t CompactMaze::getSizeY()
+{
+	return CompactMaze::sizeY;
+}
+
+std::pair<size_t, size_t> CompactMaze::getStartCell()
+{
+	return startCell;
+}
+
+std::pair<size_t, size_t> CompactMaze::getWinCell()
+{
+	return winCell;
+}
+
+//Bytes used by both bitplanes, two bits per cell plus the padding at the end of each row
+size_t CompactMaze::getMemoryUsage()
+{
+	return (eastWalls.size() + southWalls.size()) * sizeof(uint64_t);
+}
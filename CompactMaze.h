@@ -0,0 +1,58 @@
+#ifndef COMPACT_MAZE_H
+#define COMPACT_MAZE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Maze.h"
+#include "MazeRowSink.h"
+
+//A finished maze packed into two bitplanes: one bit per cell for a wall on its east side and one for a wall on
+//its south side. A cell's north and west walls are the south and east walls of its neighbours, so every wall is
+//stored once, in a quarter of the memory of a Maze, and a cell's walls can be read without decoding which side
+//recorded each passage. There is no visited bit, so only finished mazes can be held. Rows are padded to whole
+//64-bit words, so the walls of 64 cells can be read at once
+class CompactMaze : public MazeRowSink
+{
+private:
+	size_t sizeX, sizeY;
+	size_t wordsPerRow;
+	std::vector<uint64_t> eastWalls;
+	std::vector<uint64_t> southWalls;
+	std::pair<size_t, size_t> startCell;
+	std::pair<size_t, size_t> winCell;
+
+	size_t getWordIndex(size_t x, size_t y);
+	uint64_t getBit(size_t x);
+public:
+	CompactMaze(size_t sizeX, size_t sizeY);
+	//Packs a finished Maze, along with its start and win cells
+	CompactMaze(Maze* maze);
+
+	//Opens the passages of a row in the CELL_* encoding, recorded on either side, so a streaming generator
+	//can write straight into a CompactMaze
+	bool writeRow(size_t y, const uint8_t* cells);
+	void setStartCell(size_t x, size_t y);
+	void setWinCell(size_t x, size_t y);
+
+	//The cell's exits as CELL_PATH_* bits with CELL_VISITED set, so it answers the same queries as
+	//Maze::getCell(), except that every passage shows on both of its sides
+	uint8_t getCell(size_t x, size_t y);
+	//The cell's walls as CELL_PATH_* bits, including the walls around the edge of the maze
+	uint8_t getWalls(size_t x, size_t y);
+	bool hasWall(size_t x, size_t y, uint8_t direction);
+	//Expands row y into sizeX cells in the CELL_* encoding
+	void getRow(size_t y, uint8_t* cells);
+	//The east or south walls of row y, with cell x in bit x % 64 of word x / 64. Bits past the end of the row are clear
+	const uint64_t* getEastWalls(size_t y);
+	const uint64_t* getSouthWalls(size_t y);
+	size_t getWordsPerRow();
+	size_t getSizeX();
+	size_t getSizeY();
+	std::pair<size_t, size_t> getStartCell();
+	std::pair<size_t, size_t> getWinCell();
+	size_t getMemoryUsage();
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "ConcurrentDisjointSet.h"
+
+ConcurrentDisjointSet::ConcurrentDisjointSet(size_t size)
+{
+	ConcurrentDisjointSet::size = size;
+	parents = new std::atomic<uint32_t>[size];
+	for (size_t i = 0; i < size; i++)
+	{
+		parents[i].store((uint32_t)i, std::memory_order_relaxed);
+	}
+}
+
+ConcurrentDisjointSet::~ConcurrentDisjointSet()
+{
+	delete[] parents;
+}
+
+uint32_t ConcurrentDisjointSet::find(uint32_t element)
+{
+	while (true)
+	{
+		uint32_t parent = parents[element].load(std::memory_order_relaxed);
+		if (parent == element)
+		{
+			return element;
+		}
+		uint32_t grandparent = parents[parent].load(std::memory_order_relaxed);
+		if (grandparent != parent)
+		{
+			//Path halving. Losing this race is harmless, another thread has already moved the link up
+			parents[element].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+		}
+		element = grandparent;
+	}
+}
+
+bool ConcurrentDisjointSet::join(uint32_t a, uint32_t b)
+{
+	while (true)
+	{
+		a = find(a);
+		b = find(b);
+		if (a == b)
+		{
+			return false;
+		}
+		if (a > b)
+		{
+			uint32_t swap = a;
+			a = b;
+			b = swap;
+		}
+		//Only succeeds if a is still a root, otherwise another thread linked it first and the roots are found again
+		uint32_t expected = a;
+		if (parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel))
+		{
+			return true;
+		}
+	}
+}
+
+size_t ConcurrentDisjointSet::getMemoryUsage()
+{
+	return size * sizeof(std::atomic<uint32_t>);
+}
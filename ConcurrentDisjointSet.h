@@ -0,0 +1,28 @@
+#ifndef CONCURRENT_DISJOINT_SET_H
+#define CONCURRENT_DISJOINT_SET_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//Lock-free union-find over the elements 0 to size - 1, safe to use from many threads at once. Roots are
+//always linked beneath the root with the larger index, so a compare-and-swap on the smaller root's parent
+//is the only write a join needs, and parents can only ever increase, which rules out cycles
+class ConcurrentDisjointSet
+{
+private:
+	std::atomic<uint32_t>* parents;
+	size_t size;
+public:
+	//Elements are 32-bit to halve the memory and cache traffic, so size must be below 2^32
+	ConcurrentDisjointSet(size_t size);
+	~ConcurrentDisjointSet();
+
+	uint32_t find(uint32_t element);
+	//Joins the sets holding a and b, returns false if they were already the same set.
+	//When several threads join the same two sets at once, exactly one of them returns true
+	bool join(uint32_t a, uint32_t b);
+	size_t getMemoryUsage();
+};
+
+#endif
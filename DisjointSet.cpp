@@ -0,0 +1,54 @@
+#include "DisjointSet.h"
+
+DisjointSet::DisjointSet(size_t size) : parents(size), ranks(size)
+{
+	reset();
+}
+
+void DisjointSet::reset()
+{
+	for (size_t i = 0; i < parents.size(); i++)
+	{
+		parents[i] = i;
+		ranks[i] = 0;
+	}
+}
+
+size_t DisjointSet::find(size_t element)
+{
+	while (parents[element] != element)
+	{
+		//Point every other element on the way at its grandparent, which keeps the trees shallow
+		parents[element] = parents[parents[element]];
+		element = parents[element];
+	}
+	return element;
+}
+
+bool DisjointSet::join(size_t a, size_t b)
+{
+	a = find(a);
+	b = find(b);
+	if (a == b)
+	{
+		return false;
+	}
+	if (ranks[a] < ranks[b])
+	{
+		parents[a] = b;
+	}
+	else
+	{
+		parents[b] = a;
+		if (ranks[a] == ranks[b])
+		{
+			ranks[a]++;
+		}
+	}
+	return true;
+}
+
+size_t DisjointSet::getMemoryUsage()
+{
+	return parents.size() * sizeof(size_t) + ranks.size() * sizeof(uint8_t);
+}
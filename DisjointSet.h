@@ -0,0 +1,25 @@
+#ifndef DISJOINT_SET_H
+#define DISJOINT_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Union-find over the elements 0 to size - 1, with union by rank and path halving
+class DisjointSet
+{
+private:
+	std::vector<size_t> parents;
+	std::vector<uint8_t> ranks;
+public:
+	DisjointSet(size_t size);
+
+	//Puts every element back in a set of its own, without reallocating
+	void reset();
+	size_t find(size_t element);
+	//Joins the sets holding a and b, returns false if they were already the same set
+	bool join(size_t a, size_t b);
+	size_t getMemoryUsage();
+};
+
+#endif
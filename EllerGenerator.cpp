@@ -0,0 +1,128 @@
+#include "EllerGenerator.h"
+#include "DisjointSet.h"
+
+//Copies each finished row into a Maze, so the game and MazeGen see the rows appear as they are generated
+class EllerGenerator::MazeWriter : public MazeRowSink
+{
+private:
+	EllerGenerator* generator;
+	Maze* maze;
+public:
+	MazeWriter(EllerGenerator* generator, Maze* maze) : generator(generator), maze(maze)
+	{
+	}
+
+	bool writeRow(size_t y, const uint8_t* cells)
+	{
+		for (size_t x = 0; x < maze->getSizeX(); x++)
+		{
+			maze->addCellLocation(std::pair<size_t, size_t>(x, y));
+			maze->setCell(x, y, cells[x]);
+			generator->step(maze, x, y);
+		}
+		return true;
+	}
+};
+
+std::string EllerGenerator::getName()
+{
+	return "eller";
+}
+
+void EllerGenerator::carve(Maze* maze, Random& random)
+{
+	MazeWriter writer(this, maze);
+	generateRows(maze->getSizeX(), maze->getSizeY(), random, writer);
+}
+
+bool EllerGenerator::generateRows(size_t sizeX, size_t sizeY, Random& random, MazeRowSink& sink)
+{
+	const size_t NO_SET = (size_t)-1;
+	//Sets are tracked for one row at a time. A cell joined from the row above carries that row's
+	//set, named by the column of its representative there. Everything here is one entry per column
+	DisjointSet sets(sizeX);
+	std::vector<size_t> carriedSets(sizeX, NO_SET);
+	std::vector<size_t> nextSets(sizeX, NO_SET);
+	std::vector<size_t> firstColumns(sizeX, NO_SET);
+	std::vector<size_t> remaining(sizeX, 0);
+	std::vector<uint8_t> joinedDown(sizeX, 0);
+	//Passages only ever lead east or south, so a row is final once both have been decided
+	std::vector<uint8_t> row(sizeX);
+
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		bool lastRow = y == sizeY - 1;
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			row[x] = CELL_VISITED;
+		}
+		//Cells which carried the same set down from the row above start out connected
+		sets.reset();
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			size_t carried = carriedSets[x];
+			if (carried != NO_SET)
+			{
+				if (firstColumns[carried] == NO_SET)
+				{
+					firstColumns[carried] = x;
+				}
+				else
+				{
+					sets.join(firstColumns[carried], x);
+				}
+			}
+		}
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			if (carriedSets[x] != NO_SET)
+			{
+				firstColumns[carriedSets[x]] = NO_SET;
+			}
+		}
+
+		//Randomly join neighbouring cells in different sets, the last row must join all of them
+		for (size_t x = 0; x + 1 < sizeX; x++)
+		{
+			if ((lastRow || (random.next() & 1)) && sets.join(x, x + 1))
+			{
+				row[x] |= CELL_PATH_E;
+			}
+		}
+
+		if (!lastRow)
+		{
+			//Every set must continue down at least once, or it would be cut off from the rest of the maze
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				remaining[sets.find(x)]++;
+			}
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				size_t set = sets.find(x);
+				remaining[set]--;
+				if ((random.next() & 1) || (remaining[set] == 0 && !joinedDown[set]))
+				{
+					row[x] |= CELL_PATH_S;
+					joinedDown[set] = 1;
+					nextSets[x] = set;
+				}
+				else
+				{
+					nextSets[x] = NO_SET;
+				}
+			}
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				joinedDown[x] = 0;
+			}
+			carriedSets.swap(nextSets);
+		}
+
+		if (!sink.writeRow(y, row.data()))
+		{
+			return false;
+		}
+	}
+	return true;
+}
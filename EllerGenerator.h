@@ -0,0 +1,24 @@
+#ifndef ELLER_GENERATOR_H
+#define ELLER_GENERATOR_H
+
+#include "MazeGenerator.h"
+#include "MazeRowSink.h"
+
+//Eller's algorithm: builds the maze one row at a time, tracking which cells of the current row are
+//already connected. Needs memory for a single row only
+class EllerGenerator : public MazeGenerator
+{
+private:
+	class MazeWriter;
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+
+	//Generates a maze without a Maze object, passing each row to the sink as soon as it is final.
+	//Memory use depends on sizeX only, so sizeY can be as large as the sink can store.
+	//Returns false if the sink stopped generation early
+	static bool generateRows(size_t sizeX, size_t sizeY, Random& random, MazeRowSink& sink);
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "FileRowSink.h"
+#include "Maze.h"
+#include "MazeFile.h"
+#include "MazeGenerator.h"
+#include "MazeScan.h"
+
+FileRowSink::FileRowSink(const std::string& path, size_t sizeX, size_t sizeY, uint64_t seed)
+	: file(path, std::ios::out | std::ios::binary), random(MazeGenerator::getPlacementSeed(seed))
+{
+	FileRowSink::sizeX = sizeX;
+	FileRowSink::sizeY = sizeY;
+	FileRowSink::seed = seed;
+	for (int i = 0; i < 3; i++)
+	{
+		rows[i].assign(sizeX, CELL_NULL);
+	}
+	numRows = 0;
+	chosenCells[0] = std::pair<size_t, size_t>(0, 0);
+	chosenCells[1] = std::pair<size_t, size_t>(sizeX - 1, sizeY - 1);
+	numDeadEnds = 0;
+	rowDeadEnds.reserve(sizeX);
+	//The header is written again by finish(), once the start and win cells are known
+	writeHeader();
+}
+
+bool FileRowSink::writeHeader()
+{
+	file.seekp(0);
+	return MazeFile::writeHeader(file, sizeX, sizeY, seed, getStartCell(), getWinCell(), LAYOUT_ROWS, (uint64_t)sizeX * sizeY);
+}
+
+void FileRowSink::sampleDeadEnds(size_t y, const uint8_t* above, const uint8_t* cells, const uint8_t* below)
+{
+	//Passages are recorded on one side only, so the paths leading in from neighbours count too
+	rowDeadEnds.clear();
+	MazeScan::findRowDeadEnds(above, cells, below, sizeX, rowDeadEnds);
+	for (size_t i = 0; i < rowDeadEnds.size(); i++)
+	{
+		size_t slot = numDeadEnds < 2 ? numDeadEnds : random.nextBelow(numDeadEnds + 1);
+		if (slot < 2)
+		{
+			chosenCells[slot] = std::pair<size_t, size_t>(rowDeadEnds[i], y);
+		}
+		numDeadEnds++;
+	}
+}
+
+bool FileRowSink::isOpen()
+{
+	return file.is_open() && file.good();
+}
+
+bool FileRowSink::writeRow(size_t y, const uint8_t* cells)
+{
+	file.write((const char*)cells, sizeX);
+	//Rows rotate through the three buffers, with row y in buffer y % 3
+	std::vector<uint8_t>& current = rows[y % 3];
+	current.assign(cells, cells + sizeX);
+	if (y >= 1)
+	{
+		const uint8_t* above = y >= 2 ? rows[(y - 2) % 3].data() : NULL;
+		sampleDeadEnds(y - 1, above, rows[(y - 1) % 3].data(), current.data());
+	}
+	numRows = y + 1;
+	return file.good();
+}
+
+bool FileRowSink::finish()
+{
+	if (numRows > 0)
+	{
+		size_t y = numRows - 1;
+		const uint8_t* above = y >= 1 ? rows[(y - 1) % 3].data() : NULL;
+		sampleDeadEnds(y, above, rows[y % 3].data(), NULL);
+	}
+	bool written = writeHeader();
+	file.close();
+	return written && !file.fail();
+}
+
+std::pair<size_t, size_t> FileRowSink::getStartCell()
+{
+	return numDeadEnds >= 2 ? chosenCells[0] : std::pair<size_t, size_t>(0, 0);
+}
+
+std::pair<size_t, size_t> FileRowSink::getWinCell()
+{
+	return numDeadEnds >= 2 ? chosenCells[1] : std::pair<size_t, size_t>(sizeX - 1, sizeY - 1);
+}
@@ -0,0 +1,41 @@
+#ifndef FILE_ROW_SINK_H
+#define FILE_ROW_SINK_H
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "MazeRowSink.h"
+#include "Random.h"
+
+//Streams rows straight to a .maze file, in the same layout MazeGen writes for a whole Maze. The start and
+//win cells are sampled from the dead ends as rows pass through, and filled into the header by finish().
+//Sampling draws from the same placement stream as MazeGenerator, so they match an in-memory maze of the same seed
+class FileRowSink : public MazeRowSink
+{
+private:
+	std::ofstream file;
+	size_t sizeX, sizeY;
+	uint64_t seed;
+	Random random;
+	//A row's dead ends are only known once the row below it has arrived, so the last three rows are kept
+	std::vector<uint8_t> rows[3];
+	size_t numRows;
+	std::pair<size_t, size_t> chosenCells[2];
+	size_t numDeadEnds;
+	std::vector<size_t> rowDeadEnds;
+
+	bool writeHeader();
+	void sampleDeadEnds(size_t y, const uint8_t* above, const uint8_t* cells, const uint8_t* below);
+public:
+	FileRowSink(const std::string& path, size_t sizeX, size_t sizeY, uint64_t seed);
+
+	bool isOpen();
+	bool writeRow(size_t y, const uint8_t* cells);
+	//Checks the final row for dead ends and writes the chosen start and win cells, call after the last row
+	bool finish();
+	std::pair<size_t, size_t> getStartCell();
+	std::pair<size_t, size_t> getWinCell();
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "FrameUniforms.h"
+#include <cstring>
+
+const int FrameUniforms::NUM_REGIONS;
+const GLuint FrameUniforms::CAMERA_BINDING;
+const GLuint FrameUniforms::LIGHTING_BINDING;
+
+namespace
+{
+	size_t alignUp(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+}
+
+FrameUniforms::FrameUniforms()
+{
+	currentRegion = 0;
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		regionFences[i] = 0;
+	}
+	memset((void*)&camera, 0, sizeof(camera));
+	memset((void*)&lighting, 0, sizeof(lighting));
+
+	//Each block has to start at a multiple of the alignment, which is at most 256 bytes
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	cameraOffset = 0;
+	lightingOffset = alignUp(sizeof(CameraUniforms), (size_t)alignment);
+	regionSize = alignUp(lightingOffset + sizeof(LightingUniforms), (size_t)alignment);
+
+	//Immutable storage for every region, mapped once for the lifetime of the buffer
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr size = NUM_REGIONS * regionSize;
+	glGenBuffers(1, &bufferId);
+	glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+	glBufferStorage(GL_UNIFORM_BUFFER, size, NULL, flags);
+	mappedRegions = (uint8_t*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		if (regionFences[i])
+		{
+			glDeleteSync(regionFences[i]);
+		}
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+	glUnmapBuffer(GL_UNIFORM_BUFFER);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glDeleteBuffers(1, &bufferId);
+}
+
+CameraUniforms& FrameUniforms::getCamera()
+{
+	return camera;
+}
+
+LightingUniforms& FrameUniforms::getLighting()
+{
+	return lighting;
+}
+
+void FrameUniforms::beginFrame()
+{
+	//Wait until the GPU has finished with the last frame that read this region
+	GLsync fence = regionFences[currentRegion];
+	if (fence)
+	{
+		GLenum waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (waitResult == GL_TIMEOUT_EXPIRED)
+		{
+			waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		regionFences[currentRegion] = 0;
+	}
+
+	size_t regionOffset = currentRegion * regionSize;
+	memcpy(mappedRegions + regionOffset + cameraOffset, &camera, sizeof(camera));
+	memcpy(mappedRegions + regionOffset + lightingOffset, &lighting, sizeof(lighting));
+	glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BINDING, bufferId, regionOffset + cameraOffset, sizeof(CameraUniforms));
+	glBindBufferRange(GL_UNIFORM_BUFFER, LIGHTING_BINDING, bufferId, regionOffset + lightingOffset, sizeof(LightingUniforms));
+}
+
+void FrameUniforms::endFrame()
+{
+	regionFences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	currentRegion = (currentRegion + 1) % NUM_REGIONS;
+}
@@ -0,0 +1,93 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+//These structs mirror the std140 uniform blocks declared by the shaders in media, member for member. std140 starts
+//every vec3 on a 16 byte boundary but lets a float follow it in the last 4 bytes, and rounds the size of every
+//struct in an array up to 16 bytes, so floats and padding fill each vec3 out to 16 bytes here
+struct CameraUniforms
+{
+	glm::mat4 viewMatrix;
+	glm::mat4 projectionMatrix;
+	glm::vec3 viewPosition;
+	float padding;
+};
+
+struct DirectionalLightUniforms
+{
+	glm::vec3 direction;
+	float padding0;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	float padding3;
+};
+
+struct PointLightUniforms
+{
+	glm::vec3 position;
+	float constant;
+	glm::vec3 ambient;
+	float linear;
+	glm::vec3 diffuse;
+	float quadratic;
+	glm::vec3 specular;
+	float padding;
+};
+
+//MAX_POINT_LIGHTS in the shaders
+const int MAX_POINT_LIGHTS = 8;
+
+struct LightingUniforms
+{
+	DirectionalLightUniforms directionalLight;
+	PointLightUniforms pointLights[MAX_POINT_LIGHTS];
+	int numPointLights;
+	int padding[3];
+};
+
+//The camera and lighting uniform blocks shared by every shader, held in a persistently mapped ring of three
+//regions like InstanceBuffer. The blocks are edited on the CPU at any time, and beginFrame() copies them into the
+//next region and binds it, so each frame costs one copy and two binds however many shaders use them, and the GPU
+//never reads a region while it is being written. Shaders pick the blocks up by their binding points, so adding a
+//shader needs no calls here
+class FrameUniforms
+{
+private:
+	static const int NUM_REGIONS = 3;
+
+	GLuint bufferId;
+	uint8_t* mappedRegions;
+	GLsync regionFences[NUM_REGIONS];
+	int currentRegion;
+	//Offsets of the blocks within each region, and the size of a region, all multiples of the alignment GL requires
+	size_t cameraOffset;
+	size_t lightingOffset;
+	size_t regionSize;
+
+	CameraUniforms camera;
+	LightingUniforms lighting;
+public:
+	//The binding points given to the blocks in the shaders, "layout(std140, binding = n)"
+	static const GLuint CAMERA_BINDING = 0;
+	static const GLuint LIGHTING_BINDING = 1;
+
+	FrameUniforms();
+	~FrameUniforms();
+
+	CameraUniforms& getCamera();
+	LightingUniforms& getLighting();
+
+	//Copies both blocks into the next region of the ring and binds them for this frame's draws
+	void beginFrame();
+	//Fences the region used this frame so it is not overwritten while the GPU reads it
+	void endFrame();
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "Frustum.h"
+
+//A point is inside the clip volume when -w <= x, y, z <= w, and each of those six inequalities is a plane in
+//world space made from the fourth row of the matrix plus or minus one of the others (Gribb and Hartmann)
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		planes[i * 2] = rows[3] + rows[i];
+		planes[i * 2 + 1] = rows[3] - rows[i];
+	}
+}
+
+bool Frustum::intersectsBox(glm::vec3 minCorner, glm::vec3 maxCorner) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		//The corner furthest along the plane's normal is the last to leave it, so if even that is outside the box is too
+		const glm::vec4& plane = planes[i];
+		glm::vec3 corner(plane.x > 0.0f ? maxCorner.x : minCorner.x, plane.y > 0.0f ? maxCorner.y : minCorner.y, plane.z > 0.0f ? maxCorner.z : minCorner.z);
+		if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
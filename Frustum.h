@@ -0,0 +1,20 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+//The six planes bounding what a camera can see, taken from its combined projection and view matrix, so
+//anything entirely behind one of them can be skipped before it is drawn
+class Frustum
+{
+private:
+	//Each plane as (normal, distance), with the normal pointing into the frustum
+	glm::vec4 planes[6];
+public:
+	Frustum(const glm::mat4& viewProjection);
+	//Whether any part of an axis aligned box may be visible. A box beside a corner of the frustum can pass
+	//without being seen, which only costs drawing it
+	bool intersectsBox(glm::vec3 minCorner, glm::vec3 maxCorner) const;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "GrowingTreeGenerator.h"
+#include "VisitedBitboard.h"
+
+std::string GrowingTreeGenerator::getName()
+{
+	return "growingtree";
+}
+
+void GrowingTreeGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	VisitedBitboard visited(sizeX, sizeY);
+	//Cells which may still have unvisited neighbours, numbered row by row
+	std::vector<size_t> active;
+
+	size_t startX = random.nextBelow(sizeX);
+	size_t startY = random.nextBelow(sizeY);
+	maze->addCellLocation(std::pair<size_t, size_t>(startX, startY));
+	maze->setCell(startX, startY, CELL_VISITED);
+	visited.setVisited(startX, startY);
+	active.push_back(startY * sizeX + startX);
+
+	while (!active.empty())
+	{
+		//Newest cell half of the time, otherwise a random one
+		size_t chosen = (random.next() & 1) ? active.size() - 1 : random.nextBelow(active.size());
+		size_t currentX = active[chosen] % sizeX;
+		size_t currentY = active[chosen] / sizeX;
+		uint8_t possibleRoutes = visited.getUnvisitedNeighbours(currentX, currentY);
+		if (possibleRoutes == 0)
+		{
+			//Nothing left to join from here. Removing by swapping with the last cell keeps this constant time
+			active[chosen] = active.back();
+			active.pop_back();
+			continue;
+		}
+		uint8_t chosenRoute = chooseRoute(possibleRoutes, random);
+		carvePassage(maze, currentX, currentY, chosenRoute);
+		size_t nextX = currentX + DIRECTION_X[chosenRoute];
+		size_t nextY = currentY + DIRECTION_Y[chosenRoute];
+		visited.setVisited(nextX, nextY);
+		active.push_back(nextY * sizeX + nextX);
+		step(maze, nextX, nextY);
+	}
+}
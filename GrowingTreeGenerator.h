@@ -0,0 +1,16 @@
+#ifndef GROWING_TREE_GENERATOR_H
+#define GROWING_TREE_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Growing tree: extends the maze from a list of active cells, taking the newest cell half of the time and
+//a random one otherwise. Sits between the backtracker and Prim's algorithm in style
+class GrowingTreeGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
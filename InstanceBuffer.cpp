@@ -0,0 +1,138 @@
+#include "InstanceBuffer.h"
+
+const int InstanceBuffer::NUM_REGIONS;
+const size_t InstanceBuffer::NO_SLOT;
+
+InstanceBuffer::InstanceBuffer(size_t maxKeys)
+{
+	capacity = maxKeys;
+	currentRegion = 0;
+	keySlots.assign(maxKeys, NO_SLOT);
+	instances.reserve(maxKeys);
+	slotKeys.reserve(maxKeys);
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		regionFences[i] = 0;
+	}
+
+	//Immutable storage for every region, mapped once for the lifetime of the buffer
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr size = NUM_REGIONS * capacity * sizeof(glm::mat4);
+	glGenBuffers(1, &bufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+	glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+	mappedInstances = (glm::mat4*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		if (regionFences[i])
+		{
+			glDeleteSync(regionFences[i]);
+		}
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glDeleteBuffers(1, &bufferId);
+}
+
+void InstanceBuffer::markDirty(size_t slot)
+{
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		dirtySlots[i].push_back(slot);
+	}
+}
+
+//Adds an instance for this key, or replaces its matrix if it already has one
+void InstanceBuffer::set(size_t key, const glm::mat4& matrix)
+{
+	size_t slot = keySlots[key];
+	if (slot == NO_SLOT)
+	{
+		slot = instances.size();
+		keySlots[key] = slot;
+		instances.push_back(matrix);
+		slotKeys.push_back(key);
+	}
+	else
+	{
+		instances[slot] = matrix;
+	}
+	markDirty(slot);
+}
+
+//Removes the instance for this key by moving the last instance into its slot
+void InstanceBuffer::remove(size_t key)
+{
+	size_t slot = keySlots[key];
+	if (slot == NO_SLOT)
+	{
+		return;
+	}
+	size_t lastSlot = instances.size() - 1;
+	if (slot != lastSlot)
+	{
+		instances[slot] = instances[lastSlot];
+		slotKeys[slot] = slotKeys[lastSlot];
+		keySlots[slotKeys[slot]] = slot;
+		markDirty(slot);
+	}
+	instances.pop_back();
+	slotKeys.pop_back();
+	keySlots[key] = NO_SLOT;
+}
+
+bool InstanceBuffer::contains(size_t key)
+{
+	return keySlots[key] != NO_SLOT;
+}
+
+size_t InstanceBuffer::beginFrame()
+{
+	//Wait until the GPU has finished with the last frame that read this region
+	GLsync fence = regionFences[currentRegion];
+	if (fence)
+	{
+		GLenum waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (waitResult == GL_TIMEOUT_EXPIRED)
+		{
+			waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		regionFences[currentRegion] = 0;
+	}
+
+	//Copy only the slots which have changed since this region was last used
+	size_t baseInstance = currentRegion * capacity;
+	std::vector<size_t>& dirty = dirtySlots[currentRegion];
+	for (size_t i = 0; i < dirty.size(); i++)
+	{
+		if (dirty[i] < instances.size())
+		{
+			mappedInstances[baseInstance + dirty[i]] = instances[dirty[i]];
+		}
+	}
+	dirty.clear();
+	return baseInstance;
+}
+
+void InstanceBuffer::endFrame()
+{
+	regionFences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	currentRegion = (currentRegion + 1) % NUM_REGIONS;
+}
+
+GLuint InstanceBuffer::getBufferId()
+{
+	return bufferId;
+}
+
+size_t InstanceBuffer::getCount()
+{
+	return instances.size();
+}
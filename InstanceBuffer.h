@@ -0,0 +1,48 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+//A persistently mapped ring of per-instance model matrices.
+//Instances are identified by a caller-chosen key (0 to maxKeys - 1) and kept densely packed,
+//so only instances that were added, changed or moved are copied to the GPU each frame.
+class InstanceBuffer
+{
+private:
+	static const int NUM_REGIONS = 3;
+	static const size_t NO_SLOT = (size_t)-1;
+
+	GLuint bufferId;
+	size_t capacity;
+	glm::mat4* mappedInstances;
+	GLsync regionFences[NUM_REGIONS];
+	int currentRegion;
+
+	//CPU copy of the packed instances, and the mapping between keys and their slot in it
+	std::vector<glm::mat4> instances;
+	std::vector<size_t> slotKeys;
+	std::vector<size_t> keySlots;
+	//Slots each region of the ring still needs to receive
+	std::vector<size_t> dirtySlots[NUM_REGIONS];
+
+	void markDirty(size_t slot);
+public:
+	InstanceBuffer(size_t maxKeys);
+	~InstanceBuffer();
+
+	void set(size_t key, const glm::mat4& matrix);
+	void remove(size_t key);
+	bool contains(size_t key);
+
+	//Brings the next region of the ring up to date, returning the base instance to draw from
+	size_t beginFrame();
+	//Fences the region used this frame so it is not overwritten while the GPU reads it
+	void endFrame();
+
+	GLuint getBufferId();
+	size_t getCount();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "KruskalGenerator.h"
+#include <utility>
+#include "DisjointSet.h"
+
+std::string KruskalGenerator::getName()
+{
+	return "kruskal";
+}
+
+void KruskalGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	const size_t numCells = sizeX * sizeY;
+
+	//Every wall between two cells, as (cell number << 1) | 1 for the wall to its east, or << 1 alone
+	//for the wall to its south. Cells are numbered row by row, starting from 0
+	std::vector<size_t> walls;
+	walls.reserve(2 * numCells);
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			size_t cellNumber = y * sizeX + x;
+			if (x < sizeX - 1)
+			{
+				walls.push_back((cellNumber << 1) | 1);
+			}
+			if (y < sizeY - 1)
+			{
+				walls.push_back(cellNumber << 1);
+			}
+		}
+	}
+	//Fisher-Yates shuffle, so the walls are considered in a random order
+	for (size_t i = walls.size() - 1; i > 0; i--)
+	{
+		std::swap(walls[i], walls[random.nextBelow(i + 1)]);
+	}
+
+	DisjointSet sets(numCells);
+	size_t numPassages = 0;
+	for (size_t i = 0; i < walls.size() && numPassages < numCells - 1; i++)
+	{
+		size_t cellNumber = walls[i] >> 1;
+		bool east = (walls[i] & 1) != 0;
+		if (sets.join(cellNumber, east ? cellNumber + 1 : cellNumber + sizeX))
+		{
+			size_t x = cellNumber % sizeX;
+			size_t y = cellNumber / sizeX;
+			carvePassage(maze, x, y, east ? 1 : 2);
+			numPassages++;
+			step(maze, x, y);
+		}
+	}
+}
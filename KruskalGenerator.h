@@ -0,0 +1,16 @@
+#ifndef KRUSKAL_GENERATOR_H
+#define KRUSKAL_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Randomised Kruskal: removes the walls in a random order, skipping any wall whose cells are
+//already connected. Gives many short dead ends, with no bias in direction
+class KruskalGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
@@ -1,64 +1,224 @@
 #include "Maze.h"
-#include <vcruntime_string.h>
+#include <algorithm>
+#include <cstring>
 
-Maze::Maze(size_t sizeX, size_t sizeY)
+Maze::Maze(size_t sizeX, size_t sizeY, MazeTracking tracking, MazeLayout layout)
+{
+	init(sizeX, sizeY, tracking == TRACK_CHANGES, layout, NULL);
+}
+
+//Wraps cells held elsewhere, such as the pages of a mapped file, laid out as a maze of this size and layout
+//would hold them. Changes are not tracked, and the cells are not freed with the maze
+Maze::Maze(size_t sizeX, size_t sizeY, MazeLayout layout, uint8_t* cells)
+{
+	init(sizeX, sizeY, false, layout, cells);
+}
+
+void Maze::init(size_t sizeX, size_t sizeY, bool trackChanges, MazeLayout layout, uint8_t* cells)
 {
 	Maze::sizeX = sizeX;
 	Maze::sizeY = sizeY;
-	Maze::maze = new uint8_t[sizeX * sizeY];
-	memset(Maze::maze, 0x00, sizeX * sizeY);
+	Maze::currentX = 0;
+	Maze::currentY = 0;
+	Maze::metrics = MazeMetrics();
+	Maze::layout = layout;
+	Maze::tilesX = (sizeX + 7) / 8;
+	Maze::mazeLength = layout == LAYOUT_TILES ? tilesX * ((sizeY + 7) / 8) * 64 : sizeX * sizeY;
+	Maze::ownsMaze = cells == NULL;
+	if (ownsMaze)
+	{
+		Maze::maze = new uint8_t[mazeLength];
+		memset(Maze::maze, 0x00, mazeLength);
+	}
+	else
+	{
+		Maze::maze = cells;
+	}
+	Maze::trackChanges = trackChanges;
+	if (trackChanges)
+	{
+		//Every cell is added exactly once, so reserve up front rather than growing while generating
+		Maze::cellLocations.reserve(sizeX * sizeY);
+	}
+	Maze::eventLogCapacity = trackChanges ? 2 * sizeX * sizeY : 0;
+	Maze::eventLog = trackChanges ? new std::atomic<uint64_t>[eventLogCapacity] : NULL;
+	Maze::sequence.store(0);
+	Maze::generationComplete.store(false);
 }
 
-void Maze::setMaze(uint8_t* newMaze, size_t mazeLength)
+Maze::~Maze()
 {
-	maze = newMaze;
-	Maze::mazeLength = mazeLength;
+	if (ownsMaze)
+	{
+		delete[] maze;
+	}
+	delete[] eventLog;
+}
+
+//Sets the value of a cell and appends the change to the event log. Only one thread may call this
+void Maze::setCell(size_t x, size_t y, uint8_t cell)
+{
+	size_t cellIndex = getCellIndex(x, y);
+	maze[cellIndex] = cell;
+	if (!trackChanges)
+	{
+		return;
+	}
+	uint64_t nextSequence = sequence.load(std::memory_order_relaxed);
+	//Should a generator ever make more changes than the log holds, the sequence still advances
+	//so readers know to fall back to copyMaze()
+	if (nextSequence < eventLogCapacity)
+	{
+		eventLog[nextSequence].store(((uint64_t)cellIndex << 8) | cell, std::memory_order_relaxed);
+	}
+	//Release so a reader which sees the new sequence also sees the entry and the cell
+	sequence.store(nextSequence + 1, std::memory_order_release);
 }
 
 //Adds a offset for the memory location of a corresponding cell in the maze
 void Maze::addCellLocation(std::pair<size_t, size_t> cellLocation)
 {
-	Maze::cellLocations.push_back(cellLocation);
+	if (trackChanges)
+	{
+		Maze::cellLocations.push_back(cellLocation);
+	}
 }
 
-void Maze::setCurrentLocation(unsigned int currentX, unsigned int currentY)
+void Maze::setCurrentLocation(size_t currentX, size_t currentY)
 {
 	Maze::currentX = currentX;
 	Maze::currentY = currentY;
 }
 
-void Maze::setStartCell(int x, int y)
+void Maze::setStartCell(size_t x, size_t y)
+{
+	Maze::startCell = std::pair<size_t, size_t>(x, y);
+}
+
+void Maze::setWinCell(size_t x, size_t y)
+{
+	Maze::winCell = std::pair<size_t, size_t>(x, y);
+}
+
+void Maze::setMetrics(const MazeMetrics& metrics)
 {
-	Maze::startCell = std::pair<int, int>(x, y);
+	Maze::metrics = metrics;
 }
 
-void Maze::setWinCell(int x, int y)
+//Called by the generator once the maze, start and win cells are final
+void Maze::setGenerationComplete()
 {
-	Maze::winCell = std::pair<int, int>(x, y);
+	Maze::generationComplete.store(true);
 }
 
-//Returns a pointer to the maze. Correct locations 
+//Returns a pointer to the maze. Correct locations are found with getCellIndex(), as they depend on the layout
 uint8_t* Maze::getMaze()
 {
 	return maze;
 }
 
-//Gets the amount of ram required for maze in bytes
+//Gets the amount of ram required for maze in bytes, including any padding for the layout
 size_t Maze::getMazeLength()
 {
-	return sizeof(uint8_t) * sizeX * sizeY;
+	return sizeof(uint8_t) * mazeLength;
+}
+
+size_t Maze::getMazeNumElements()
+{
+	return sizeX * sizeY;
+}
+
+MazeLayout Maze::getLayout()
+{
+	return layout;
+}
+
+//Offset of a cell within the maze array, 64-bit so mazes may exceed 4 billion cells
+size_t Maze::getCellIndex(size_t x, size_t y)
+{
+	if (layout == LAYOUT_TILES)
+	{
+		return (((y >> 3) * tilesX + (x >> 3)) << 6) | ((y & 7) << 3) | (x & 7);
+	}
+	return y * sizeX + x;
+}
+
+uint8_t Maze::getCell(size_t x, size_t y)
+{
+	return maze[getCellIndex(x, y)];
 }
 
-int Maze::getMazeNumElements()
+//Row y as sizeX consecutive cells. With the row layout this points straight into the maze, otherwise the
+//row is gathered into buffer, which must hold sizeX cells, and buffer is returned
+const uint8_t* Maze::getRow(size_t y, uint8_t* buffer)
 {
-	return mazeLength / sizeof(int8_t);
+	if (layout == LAYOUT_ROWS)
+	{
+		return maze + y * sizeX;
+	}
+	for (size_t x = 0; x < sizeX; x += 8)
+	{
+		memcpy(buffer + x, maze + getCellIndex(x, y), std::min(sizeX - x, (size_t)8));
+	}
+	return buffer;
 }
 
-std::vector<std::pair<size_t, size_t>> Maze::getCellLocations()
+bool Maze::isTrackingChanges()
+{
+	return trackChanges;
+}
+
+const std::vector<std::pair<size_t, size_t>>& Maze::getCellLocations()
 {
 	return Maze::cellLocations;
 }
 
+//Sequence number of the next change, pass to getChangesSince() to receive only newer changes
+uint64_t Maze::getSequence()
+{
+	return Maze::sequence.load(std::memory_order_acquire);
+}
+
+//Appends up to maxChanges of the changes made from sinceSequence onwards, in order, and advances
+//sinceSequence past them. The whole history is kept, so a reader can replay generation at any pace.
+//Returns false only if the log has overflowed, in which case the caller must use copyMaze() instead.
+//Never blocks the generator, entries are never overwritten once published
+bool Maze::getChangesSince(uint64_t& sinceSequence, std::vector<MazeChange>& changes, size_t maxChanges)
+{
+	if (!trackChanges)
+	{
+		return false;
+	}
+	uint64_t endSequence = sequence.load(std::memory_order_acquire);
+	if (endSequence - sinceSequence > maxChanges)
+	{
+		endSequence = sinceSequence + maxChanges;
+	}
+	if (endSequence > eventLogCapacity)
+	{
+		return endSequence == sinceSequence;
+	}
+	for (uint64_t i = sinceSequence; i < endSequence; i++)
+	{
+		uint64_t entry = eventLog[i].load(std::memory_order_relaxed);
+		MazeChange change;
+		change.cellIndex = (size_t)(entry >> 8);
+		change.cell = (uint8_t)(entry & 0xFF);
+		changes.push_back(change);
+	}
+	sinceSequence = endSequence;
+	return true;
+}
+
+//Copies the whole maze, returning the sequence to read changes from afterwards. The cells are not atomic,
+//so this may only be called once the generator has finished writing them
+uint64_t Maze::copyMaze(uint8_t* destination)
+{
+	uint64_t copySequence = sequence.load(std::memory_order_acquire);
+	memcpy(destination, maze, getMazeLength());
+	return copySequence;
+}
+
 size_t Maze::getSizeX()
 {
 	return Maze::sizeX;
@@ -69,22 +229,32 @@ size_t Maze::getSizeY()
 	return Maze::sizeY;
 }
 
-int Maze::getCurrentX()
+size_t Maze::getCurrentX()
 {
 	return Maze::currentX;
 }
 
-int Maze::getCurrentY()
+size_t Maze::getCurrentY()
 {
 	return Maze::currentY;
 }
 
-std::pair<int, int> Maze::getStartCell()
+std::pair<size_t, size_t> Maze::getStartCell()
 {
 	return startCell;
 }
 
-std::pair<int, int> Maze::getWinCell()
+std::pair<size_t, size_t> Maze::getWinCell()
 {
 	return winCell;
 }
+
+MazeMetrics Maze::getMetrics()
+{
+	return metrics;
+}
+
+bool Maze::isGenerationComplete()
+{
+	return Maze::generationComplete.load();
+}
\ No newline at end of file
@@ -1,39 +1,115 @@
 #ifndef MAZE_H
 #define MAZE_H
 
-#include <glad/glad.h>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <glm/glm.hpp>
+#include <utility>
 #include <vector>
 
+//Constants to define maze paths
+enum
+{
+	CELL_NULL = 0x00,
+	CELL_PATH_N = 0x01,	//Constants numbered to have 1 bit each
+	CELL_PATH_E = 0x02,
+	CELL_PATH_S = 0x04,
+	CELL_PATH_W = 0x08,
+	CELL_VISITED = 0x10
+};
+
+//How cells are arranged in the maze array. LAYOUT_ROWS stores each row after the last. LAYOUT_TILES stores
+//8x8 blocks of cells, each in one 64-byte cache line, so a cell's north and south neighbours are usually in
+//the same line rather than a whole row away; the last row and column of blocks are padded to full size
+enum MazeLayout
+{
+	LAYOUT_ROWS,
+	LAYOUT_TILES
+};
+
+//Whether a maze keeps the cell location list and event log the renderer reads. A type of its own rather than a
+//bool, so that a MazeLayout passed in its place does not compile
+enum MazeTracking
+{
+	TRACK_CHANGES,
+	NO_TRACKING
+};
+
+//A single change to the maze, as recorded in its event log
+struct MazeChange
+{
+	size_t cellIndex;
+	uint8_t cell;
+};
+
+//Difficulty measures for a maze, filled in when its start and win cells are placed at the ends of its longest route
+struct MazeMetrics
+{
+	uint64_t routeLength;	//Cells on the route from start to win, including both
+	uint64_t numDeadEnds;
+	uint64_t numJunctions;	//Cells with three or more exits
+	uint64_t routeJunctions;	//Junctions on the route, where the player has to choose
+	double branchingFactor;	//Average number of ways forward at each step of the route, 1 when it has no side branches
+};
+
 class Maze
 {
 private:
-	size_t sizeX, sizeY, mazeLength;
-	int currentX, currentY;
-	std::pair<int, int> startCell;
-	std::pair<int, int> winCell;
+	size_t sizeX, sizeY;
+	size_t currentX, currentY;
+	std::pair<size_t, size_t> startCell;
+	std::pair<size_t, size_t> winCell;
+	MazeMetrics metrics;
 	uint8_t *maze;
+	bool ownsMaze;
+	MazeLayout layout;
+	size_t tilesX;
+	size_t mazeLength;
+	//Large mazes are generated without the cell location list or event log, which only the renderer needs
+	bool trackChanges;
 	std::vector<std::pair<size_t, size_t>> cellLocations;
+	//Every change in the order it was made, each packed as (cell index << 8 | cell), with the sequence number
+	//of the next change to be recorded. Allocated up front for 2 changes per cell, which covers every
+	//generator, so it never moves while it is written by the generator thread and read without locking
+	std::atomic<uint64_t>* eventLog;
+	size_t eventLogCapacity;
+	std::atomic<uint64_t> sequence;
+	std::atomic<bool> generationComplete;
+
+	void init(size_t sizeX, size_t sizeY, bool trackChanges, MazeLayout layout, uint8_t* cells);
 public:
-	Maze(size_t sizeX, size_t sizeY);
+	Maze(size_t sizeX, size_t sizeY, MazeTracking tracking = TRACK_CHANGES, MazeLayout layout = LAYOUT_ROWS);
+	Maze(size_t sizeX, size_t sizeY, MazeLayout layout, uint8_t* cells);
+	~Maze();
 
-	void setMaze(uint8_t *newMaze, size_t mazeLength);
+	void setCell(size_t x, size_t y, uint8_t cell);
 	void addCellLocation(std::pair<size_t, size_t>);
-	void setCurrentLocation(unsigned int currentX, unsigned int currentY);
-	void setStartCell(int x, int y);
-	void setWinCell(int x, int y);
+	void setCurrentLocation(size_t currentX, size_t currentY);
+	void setStartCell(size_t x, size_t y);
+	void setWinCell(size_t x, size_t y);
+	void setMetrics(const MazeMetrics& metrics);
+	void setGenerationComplete();
 
 	uint8_t* getMaze();
 	size_t getMazeLength();
-	int getMazeNumElements();
-	std::vector<std::pair<size_t, size_t>> getCellLocations();
+	size_t getMazeNumElements();
+	MazeLayout getLayout();
+	size_t getCellIndex(size_t x, size_t y);
+	uint8_t getCell(size_t x, size_t y);
+	const uint8_t* getRow(size_t y, uint8_t* buffer);
+	bool isTrackingChanges();
+	const std::vector<std::pair<size_t, size_t>>& getCellLocations();
+	uint64_t getSequence();
+	bool getChangesSince(uint64_t& sinceSequence, std::vector<MazeChange>& changes, size_t maxChanges = SIZE_MAX);
+	uint64_t copyMaze(uint8_t* destination);
 	size_t getSizeX();
 	size_t getSizeY();
-	int getCurrentX();
-	int getCurrentY();
-	std::pair<int, int> getStartCell();
-	std::pair<int, int> getWinCell();
+	size_t getCurrentX();
+	size_t getCurrentY();
+	std::pair<size_t, size_t> getStartCell();
+	std::pair<size_t, size_t> getWinCell();
+	MazeMetrics getMetrics();
+	bool isGenerationComplete();
 };
 
 #endif
@@ -0,0 +1,494 @@
+#include "MazeArchive.h"
+#include "MazeScan.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	struct ArchiveHeader
+	{
+		char magic[4];	//"MZAR"
+		uint32_t version;
+		uint64_t numMazes;
+		uint64_t indexOffset;
+	};
+
+	//Each cell of a chunk is coded as these two bits
+	enum
+	{
+		PASSAGE_E = 0x01,
+		PASSAGE_S = 0x02
+	};
+
+	//Probabilities are 11-bit fixed point chances of a 0 bit, adapting by 1/32 of the difference per bit
+	const uint32_t PROBABILITY_BITS = 11;
+	const uint16_t PROBABILITY_HALF = 1 << (PROBABILITY_BITS - 1);
+	const int ADAPT_SHIFT = 5;
+	const uint32_t RANGE_TOP = 1 << 24;
+
+	//Binary range coder in the style of LZMA's, encoding into a byte vector
+	class RangeEncoder
+	{
+	private:
+		std::vector<uint8_t>& output;
+		uint64_t low;
+		uint32_t range;
+		uint8_t cache;
+		uint64_t cacheSize;
+
+		//Moves the top byte of low out, holding back runs of 0xFF until it is known whether a carry will reach them
+		void shiftLow()
+		{
+			if ((uint32_t)low < 0xFF000000 || (low >> 32) != 0)
+			{
+				uint8_t carry = (uint8_t)(low >> 32);
+				uint8_t pending = cache;
+				do
+				{
+					output.push_back((uint8_t)(pending + carry));
+					pending = 0xFF;
+				} while (--cacheSize != 0);
+				cache = (uint8_t)(low >> 24);
+			}
+			cacheSize++;
+			low = (low & 0x00FFFFFF) << 8;
+		}
+	public:
+		RangeEncoder(std::vector<uint8_t>& output) : output(output), low(0), range(0xFFFFFFFF), cache(0), cacheSize(1) {}
+
+		void code(uint16_t& probability, uint8_t& bit)
+		{
+			uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+			if (bit == 0)
+			{
+				range = bound;
+				probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+			}
+			else
+			{
+				low += bound;
+				range -= bound;
+				probability -= probability >> ADAPT_SHIFT;
+			}
+			while (range < RANGE_TOP)
+			{
+				range <<= 8;
+				shiftLow();
+			}
+		}
+
+		void flush()
+		{
+			for (int i = 0; i < 5; i++)
+			{
+				shiftLow();
+			}
+		}
+	};
+
+	//Decodes what RangeEncoder wrote, reading zeros past the end of the input so a damaged chunk cannot overrun it
+	class RangeDecoder
+	{
+	private:
+		const uint8_t* input;
+		const uint8_t* end;
+		uint32_t range;
+		uint32_t value;
+
+		uint8_t nextByte()
+		{
+			return input < end ? *input++ : 0;
+		}
+	public:
+		RangeDecoder(const uint8_t* input, size_t length) : input(input), end(input + length), range(0xFFFFFFFF), value(0)
+		{
+			for (int i = 0; i < 5; i++)
+			{
+				value = (value << 8) | nextByte();
+			}
+		}
+
+		void code(uint16_t& probability, uint8_t& bit)
+		{
+			uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+			if (value < bound)
+			{
+				range = bound;
+				probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+				bit = 0;
+			}
+			else
+			{
+				value -= bound;
+				range -= bound;
+				probability -= probability >> ADAPT_SHIFT;
+				bit = 1;
+			}
+			while (range < RANGE_TOP)
+			{
+				range <<= 8;
+				value = (value << 8) | nextByte();
+			}
+		}
+	};
+
+	//Codes the passages of one chunk, width x height cells row by row, with either coder, so encoding and decoding
+	//always see the same contexts. The chance of a passage is learned separately for each arrangement of the
+	//passages already coded next to it: the west cell's east passage and the north cell's south and east passages,
+	//and for a south passage also the cell's own east passage. Passages out of the maze are never coded
+	template <class Coder>
+	void codeChunk(Coder& coder, uint8_t* passages, size_t width, size_t height, bool lastColumnIsEdge, bool lastRowIsEdge)
+	{
+		uint16_t eastProbabilities[8];
+		uint16_t southProbabilities[16];
+		std::fill(eastProbabilities, eastProbabilities + 8, PROBABILITY_HALF);
+		std::fill(southProbabilities, southProbabilities + 16, PROBABILITY_HALF);
+		for (size_t y = 0; y < height; y++)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				uint8_t* cell = passages + y * width + x;
+				uint8_t west = x > 0 ? cell[-1] : 0;
+				uint8_t north = y > 0 ? cell[-(ptrdiff_t)width] : 0;
+				int context = (west & PASSAGE_E) | (north & PASSAGE_S) | ((north & PASSAGE_E) << 2);
+				uint8_t east = (*cell & PASSAGE_E) ? 1 : 0;
+				uint8_t south = (*cell & PASSAGE_S) ? 1 : 0;
+				if (!(lastColumnIsEdge && x == width - 1))
+				{
+					coder.code(eastProbabilities[context], east);
+				}
+				if (!(lastRowIsEdge && y == height - 1))
+				{
+					coder.code(southProbabilities[context | (east << 3)], south);
+				}
+				*cell = (uint8_t)((east ? PASSAGE_E : 0) | (south ? PASSAGE_S : 0));
+			}
+		}
+	}
+}
+
+MazeArchive::MazeArchive()
+{
+	MazeArchive::writing = false;
+	MazeArchive::loadedMaze = SIZE_MAX;
+	memset(&loadedEntry, 0, sizeof(loadedEntry));
+}
+
+MazeArchive::~MazeArchive()
+{
+	if (writing)
+	{
+		finish();
+	}
+}
+
+bool MazeArchive::writeHeader(uint64_t indexOffset)
+{
+	ArchiveHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "MZAR", 4);
+	header.version = VERSION;
+	header.numMazes = mazeOffsets.size();
+	header.indexOffset = indexOffset;
+	file.seekp(0);
+	file.write((const char*)&header, sizeof(header));
+	return file.good();
+}
+
+bool MazeArchive::create(const std::string& path)
+{
+	file.close();
+	file.clear();
+	file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+	mazeOffsets.clear();
+	loadedMaze = SIZE_MAX;
+	writing = file.is_open();
+	//Written again by finish(), once the index is in place
+	return writing && writeHeader(0);
+}
+
+bool MazeArchive::addMaze(Maze* maze, uint64_t seed)
+{
+	if (!writing)
+	{
+		return false;
+	}
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	size_t chunksX = (sizeX + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	size_t chunksY = (sizeY + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	MazeArchiveEntry entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.sizeX = sizeX;
+	entry.sizeY = sizeY;
+	entry.seed = seed;
+	entry.startX = maze->getStartCell().first;
+	entry.startY = maze->getStartCell().second;
+	entry.winX = maze->getWinCell().first;
+	entry.winY = maze->getWinCell().second;
+	entry.chunkSize = CHUNK_SIZE;
+
+	file.seekp(0, std::ios::end);
+	uint64_t entryOffset = (uint64_t)file.tellp();
+	file.write((const char*)&entry, sizeof(entry));
+	//The chunk table is filled in once every chunk's size is known. Offsets count from the first chunk,
+	//with one more at the end so every chunk's length is the difference of two offsets
+	std::vector<uint64_t> chunkOffsets(chunksX * chunksY + 1, 0);
+	uint64_t tableOffset = (uint64_t)file.tellp();
+	file.write((const char*)chunkOffsets.data(), chunkOffsets.size() * sizeof(uint64_t));
+
+	//One band of chunks at a time, finding every cell's passages from its exits a row at a time
+	std::vector<uint8_t> rowBuffers(3 * sizeX);
+	std::vector<uint8_t> exits(sizeX);
+	std::vector<uint8_t> band(sizeX * CHUNK_SIZE);
+	std::vector<uint8_t> chunk(CHUNK_SIZE * CHUNK_SIZE);
+	uint64_t chunkOffset = 0;
+	for (size_t chunkY = 0; chunkY < chunksY; chunkY++)
+	{
+		size_t bandY = chunkY * CHUNK_SIZE;
+		size_t bandHeight = std::min((size_t)CHUNK_SIZE, sizeY - bandY);
+		for (size_t y = bandY; y < bandY + bandHeight; y++)
+		{
+			const uint8_t* above = y > 0 ? maze->getRow(y - 1, rowBuffers.data()) : NULL;
+			const uint8_t* row = maze->getRow(y, rowBuffers.data() + sizeX);
+			const uint8_t* below = y < sizeY - 1 ? maze->getRow(y + 1, rowBuffers.data() + 2 * sizeX) : NULL;
+			MazeScan::getRowExits(above, row, below, sizeX, exits.data());
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				band[(y - bandY) * sizeX + x] = (uint8_t)(((exits[x] & CELL_PATH_E) ? PASSAGE_E : 0) | ((exits[x] & CELL_PATH_S) ? PASSAGE_S : 0));
+			}
+		}
+		for (size_t chunkX = 0; chunkX < chunksX; chunkX++)
+		{
+			size_t chunkStartX = chunkX * CHUNK_SIZE;
+			size_t chunkWidth = std::min((size_t)CHUNK_SIZE, sizeX - chunkStartX);
+			for (size_t y = 0; y < bandHeight; y++)
+			{
+				memcpy(chunk.data() + y * chunkWidth, band.data() + y * sizeX + chunkStartX, chunkWidth);
+			}
+			chunkData.clear();
+			RangeEncoder encoder(chunkData);
+			codeChunk(encoder, chunk.data(), chunkWidth, bandHeight, chunkStartX + chunkWidth == sizeX, bandY + bandHeight == sizeY);
+			encoder.flush();
+			file.write((const char*)chunkData.data(), chunkData.size());
+			chunkOffset += chunkData.size();
+			chunkOffsets[chunkY * chunksX + chunkX + 1] = chunkOffset;
+		}
+	}
+
+	file.seekp(tableOffset);
+	file.write((const char*)chunkOffsets.data(), chunkOffsets.size() * sizeof(uint64_t));
+	file.seekp(0, std::ios::end);
+	mazeOffsets.push_back(entryOffset);
+	return file.good();
+}
+
+bool MazeArchive::finish()
+{
+	if (!writing)
+	{
+		return false;
+	}
+	file.seekp(0, std::ios::end);
+	uint64_t indexOffset = (uint64_t)file.tellp();
+	file.write((const char*)mazeOffsets.data(), mazeOffsets.size() * sizeof(uint64_t));
+	bool written = writeHeader(indexOffset);
+	file.close();
+	writing = false;
+	return written;
+}
+
+bool MazeArchive::open(const std::string& path)
+{
+	file.close();
+	file.clear();
+	writing = false;
+	loadedMaze = SIZE_MAX;
+	mazeOffsets.clear();
+	file.open(path, std::ios::in | std::ios::binary);
+	ArchiveHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, "MZAR", 4) != 0 || header.version != VERSION)
+	{
+		file.close();
+		return false;
+	}
+	uint64_t fileLength = (uint64_t)file.seekg(0, std::ios::end).tellg();
+	if (header.indexOffset > fileLength || header.numMazes > (fileLength - header.indexOffset) / sizeof(uint64_t))
+	{
+		file.close();
+		return false;
+	}
+	mazeOffsets.resize((size_t)header.numMazes);
+	file.seekg(header.indexOffset);
+	file.read((char*)mazeOffsets.data(), mazeOffsets.size() * sizeof(uint64_t));
+	return file.good();
+}
+
+size_t MazeArchive::getNumMazes()
+{
+	return mazeOffsets.size();
+}
+
+bool MazeArchive::loadMaze(size_t index)
+{
+	if (writing || index >= mazeOffsets.size())
+	{
+		return false;
+	}
+	if (index == loadedMaze)
+	{
+		return true;
+	}
+	loadedMaze = SIZE_MAX;
+	file.clear();
+	file.seekg(mazeOffsets[index]);
+	if (!file.read((char*)&loadedEntry, sizeof(loadedEntry)) || loadedEntry.sizeX == 0 || loadedEntry.sizeY == 0 ||
+		loadedEntry.chunkSize == 0 || loadedEntry.chunkSize > 4096)
+	{
+		return false;
+	}
+	size_t chunksX = (size_t)((loadedEntry.sizeX + loadedEntry.chunkSize - 1) / loadedEntry.chunkSize);
+	size_t chunksY = (size_t)((loadedEntry.sizeY + loadedEntry.chunkSize - 1) / loadedEntry.chunkSize);
+	loadedChunkOffsets.resize(chunksX * chunksY + 1);
+	if (!file.read((char*)loadedChunkOffsets.data(), loadedChunkOffsets.size() * sizeof(uint64_t)))
+	{
+		return false;
+	}
+	loadedMaze = index;
+	return true;
+}
+
+//Decodes one chunk of the loaded maze into chunkPassages, chunkSize cells to a row
+bool MazeArchive::decodeChunk(size_t chunkX, size_t chunkY)
+{
+	size_t chunkSize = loadedEntry.chunkSize;
+	size_t chunksX = (size_t)((loadedEntry.sizeX + chunkSize - 1) / chunkSize);
+	size_t chunk = chunkY * chunksX + chunkX;
+	uint64_t start = loadedChunkOffsets[chunk];
+	uint64_t end = loadedChunkOffsets[chunk + 1];
+	if (end < start || end - start > 16 * chunkSize * chunkSize)
+	{
+		return false;
+	}
+	uint64_t dataOffset = mazeOffsets[loadedMaze] + sizeof(MazeArchiveEntry) + loadedChunkOffsets.size() * sizeof(uint64_t);
+	chunkData.resize((size_t)(end - start));
+	file.clear();
+	file.seekg(dataOffset + start);
+	if (!file.read((char*)chunkData.data(), chunkData.size()))
+	{
+		return false;
+	}
+	size_t chunkStartX = chunkX * chunkSize;
+	size_t chunkStartY = chunkY * chunkSize;
+	size_t chunkWidth = std::min(chunkSize, (size_t)loadedEntry.sizeX - chunkStartX);
+	size_t chunkHeight = std::min(chunkSize, (size_t)loadedEntry.sizeY - chunkStartY);
+	chunkPassages.assign(chunkWidth * chunkHeight, 0);
+	RangeDecoder decoder(chunkData.data(), chunkData.size());
+	codeChunk(decoder, chunkPassages.data(), chunkWidth, chunkHeight, chunkStartX + chunkWidth == loadedEntry.sizeX, chunkStartY + chunkHeight == loadedEntry.sizeY);
+	//Spread the rows out to chunkSize so callers can index every chunk alike
+	if (chunkWidth != chunkSize || chunkHeight != chunkSize)
+	{
+		std::vector<uint8_t> packed(chunkPassages);
+		chunkPassages.assign(chunkSize * chunkSize, 0);
+		for (size_t y = 0; y < chunkHeight; y++)
+		{
+			memcpy(chunkPassages.data() + y * chunkSize, packed.data() + y * chunkWidth, chunkWidth);
+		}
+	}
+	return true;
+}
+
+bool MazeArchive::getEntry(size_t index, MazeArchiveEntry& entry)
+{
+	if (!loadMaze(index))
+	{
+		return false;
+	}
+	entry = loadedEntry;
+	return true;
+}
+
+bool MazeArchive::readRegion(size_t index, size_t x, size_t y, size_t width, size_t height, uint8_t* cells)
+{
+	if (!loadMaze(index) || width == 0 || height == 0 || x >= loadedEntry.sizeX || y >= loadedEntry.sizeY ||
+		width > loadedEntry.sizeX - x || height > loadedEntry.sizeY - y)
+	{
+		return false;
+	}
+	//The passages of the region and of the column to its west and the row to its north, which hold the
+	//region's west and north passages
+	size_t windowX = x > 0 ? x - 1 : x;
+	size_t windowY = y > 0 ? y - 1 : y;
+	size_t windowWidth = x + width - windowX;
+	size_t windowHeight = y + height - windowY;
+	std::vector<uint8_t> window(windowWidth * windowHeight, 0);
+	size_t chunkSize = loadedEntry.chunkSize;
+	for (size_t chunkY = windowY / chunkSize; chunkY <= (y + height - 1) / chunkSize; chunkY++)
+	{
+		for (size_t chunkX = windowX / chunkSize; chunkX <= (x + width - 1) / chunkSize; chunkX++)
+		{
+			if (!decodeChunk(chunkX, chunkY))
+			{
+				return false;
+			}
+			//Copy the part of the chunk which overlaps the window
+			size_t fromX = std::max(windowX, chunkX * chunkSize);
+			size_t toX = std::min(x + width, (chunkX + 1) * chunkSize);
+			size_t fromY = std::max(windowY, chunkY * chunkSize);
+			size_t toY = std::min(y + height, (chunkY + 1) * chunkSize);
+			for (size_t cellY = fromY; cellY < toY; cellY++)
+			{
+				memcpy(window.data() + (cellY - windowY) * windowWidth + (fromX - windowX),
+					chunkPassages.data() + (cellY - chunkY * chunkSize) * chunkSize + (fromX - chunkX * chunkSize), toX - fromX);
+			}
+		}
+	}
+	for (size_t cellY = y; cellY < y + height; cellY++)
+	{
+		for (size_t cellX = x; cellX < x + width; cellX++)
+		{
+			const uint8_t* passage = window.data() + (cellY - windowY) * windowWidth + (cellX - windowX);
+			uint8_t cell = CELL_VISITED;
+			cell |= (*passage & PASSAGE_E) ? CELL_PATH_E : 0;
+			cell |= (*passage & PASSAGE_S) ? CELL_PATH_S : 0;
+			cell |= (cellX > 0 && (passage[-1] & PASSAGE_E)) ? CELL_PATH_W : 0;
+			cell |= (cellY > 0 && (passage[-(ptrdiff_t)windowWidth] & PASSAGE_S)) ? CELL_PATH_N : 0;
+			cells[(cellY - y) * width + (cellX - x)] = cell;
+		}
+	}
+	return true;
+}
+
+bool MazeArchive::readMaze(size_t index, Maze* maze)
+{
+	if (!loadMaze(index) || maze->getSizeX() != loadedEntry.sizeX || maze->getSizeY() != loadedEntry.sizeY)
+	{
+		return false;
+	}
+	//Every passage is recorded on the side of the cell to its west or north, which needs no neighbouring chunk
+	size_t chunkSize = loadedEntry.chunkSize;
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	for (size_t chunkY = 0; chunkY * chunkSize < sizeY; chunkY++)
+	{
+		for (size_t chunkX = 0; chunkX * chunkSize < sizeX; chunkX++)
+		{
+			if (!decodeChunk(chunkX, chunkY))
+			{
+				return false;
+			}
+			for (size_t cellY = chunkY * chunkSize; cellY < std::min(sizeY, (chunkY + 1) * chunkSize); cellY++)
+			{
+				for (size_t cellX = chunkX * chunkSize; cellX < std::min(sizeX, (chunkX + 1) * chunkSize); cellX++)
+				{
+					uint8_t passage = chunkPassages[(cellY - chunkY * chunkSize) * chunkSize + (cellX - chunkX * chunkSize)];
+					maze->setCell(cellX, cellY, (uint8_t)(CELL_VISITED | ((passage & PASSAGE_E) ? CELL_PATH_E : 0) | ((passage & PASSAGE_S) ? CELL_PATH_S : 0)));
+				}
+			}
+		}
+	}
+	maze->setStartCell((size_t)loadedEntry.startX, (size_t)loadedEntry.startY);
+	maze->setWinCell((size_t)loadedEntry.winX, (size_t)loadedEntry.winY);
+	maze->setGenerationComplete();
+	return true;
+}
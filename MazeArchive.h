@@ -0,0 +1,71 @@
+#ifndef MAZE_ARCHIVE_H
+#define MAZE_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Maze.h"
+
+//What the archive records about each maze, besides its cells
+struct MazeArchiveEntry
+{
+	uint64_t sizeX, sizeY;
+	uint64_t seed;
+	uint64_t startX, startY;
+	uint64_t winX, winY;
+	uint32_t chunkSize;
+	uint32_t reserved;
+};
+
+//A compressed container for many mazes. Each maze is cut into chunks of CHUNK_SIZE x CHUNK_SIZE cells, and
+//each chunk stores only whether every cell has a passage to the east and to the south (its north and west
+//passages are its neighbours' south and east), compressed with an adaptive binary range coder whose
+//probabilities depend on the passages already seen around the cell. Chunks are coded independently and
+//listed in a table per maze, and the mazes are listed in an index at the end of the file, so any region of
+//any maze can be decoded without inflating anything else.
+//Layout: archive header, then per maze its MazeArchiveEntry, chunk offset table and chunks, then the index
+class MazeArchive
+{
+private:
+	std::fstream file;
+	bool writing;
+	std::vector<uint64_t> mazeOffsets;
+	//The maze whose entry and chunk table were read last, so regions of one maze can be read without re-reading them
+	size_t loadedMaze;
+	MazeArchiveEntry loadedEntry;
+	std::vector<uint64_t> loadedChunkOffsets;
+	std::vector<uint8_t> chunkData;
+	std::vector<uint8_t> chunkPassages;
+
+	bool writeHeader(uint64_t indexOffset);
+	bool loadMaze(size_t index);
+	bool decodeChunk(size_t chunkX, size_t chunkY);
+public:
+	static const uint32_t VERSION = 1;
+	static const uint32_t CHUNK_SIZE = 64;
+
+	MazeArchive();
+	~MazeArchive();
+
+	//Starts a new archive, replacing any file at path
+	bool create(const std::string& path);
+	//Compresses a finished maze and appends it to an archive being created
+	bool addMaze(Maze* maze, uint64_t seed);
+	//Writes the index; the archive cannot be read until this is done
+	bool finish();
+
+	//Opens an archive written by finish() for reading
+	bool open(const std::string& path);
+	size_t getNumMazes();
+	bool getEntry(size_t index, MazeArchiveEntry& entry);
+	//Decodes width x height cells from (x, y) of maze index into cells, row by row. Each cell holds all of its
+	//exits as CELL_PATH_* bits, including passages to cells outside the region, with CELL_VISITED set
+	bool readRegion(size_t index, size_t x, size_t y, size_t width, size_t height, uint8_t* cells);
+	//Decodes a whole maze into a Maze of the same size, including its start and win cells
+	bool readMaze(size_t index, Maze* maze);
+};
+
+#endif
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Maze.h"
+#include "MazeGenerator.h"
+#include "MazeScan.h"
+#include "ParallelKruskalGenerator.h"
+
+//Every heap allocation in the program goes through these, so generation can be checked for allocator traffic
+//and for the working memory it needs. Each block is prefixed with its size so that frees can be counted too
+const size_t BLOCK_HEADER = 16;
+std::atomic<size_t> allocationCount(0);
+std::atomic<size_t> allocatedBytes(0);
+std::atomic<size_t> peakAllocatedBytes(0);
+
+void* operator new(size_t size)
+{
+	allocationCount++;
+	char* memory = (char*)malloc(size + BLOCK_HEADER);
+	if (memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	*(size_t*)memory = size;
+	size_t allocated = allocatedBytes += size;
+	size_t peak = peakAllocatedBytes.load();
+	while (allocated > peak && !peakAllocatedBytes.compare_exchange_weak(peak, allocated))
+	{
+	}
+	return memory + BLOCK_HEADER;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory == NULL)
+	{
+		return;
+	}
+	char* block = (char*)memory - BLOCK_HEADER;
+	allocatedBytes -= *(size_t*)block;
+	free(block);
+}
+
+struct BenchResult
+{
+	double seconds;
+	size_t allocations;
+	size_t peakBytes;
+};
+
+//Generates repeats mazes of the given size, timing only the generator and measuring the allocations
+//it makes and the most memory it held at once, on top of the maze itself
+BenchResult benchGenerator(MazeGenerator* generator, size_t size, bool trackChanges, int repeats, MazeLayout layout = LAYOUT_ROWS)
+{
+	BenchResult result = { 0.0, 0, 0 };
+	for (int i = 0; i < repeats; i++)
+	{
+		Maze maze(size, size, trackChanges ? TRACK_CHANGES : NO_TRACKING, layout);
+		size_t allocationsBefore = allocationCount.load();
+		size_t bytesBefore = allocatedBytes.load();
+		peakAllocatedBytes = bytesBefore;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		generator->generate(&maze, i + 1);
+		result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.allocations += allocationCount.load() - allocationsBefore;
+		result.peakBytes = std::max(result.peakBytes, peakAllocatedBytes.load() - bytesBefore);
+	}
+	return result;
+}
+
+//Breadth first search from the start cell to the win cell, reading every cell through the Maze accessors,
+//so half of all neighbour reads are a row away. The search's own array is indexed like the maze, so it shares
+//its layout. Returns the number of cells on the route
+size_t solveMaze(Maze* maze, std::vector<uint64_t>& queue, std::vector<uint8_t>& cameFrom)
+{
+	const ptrdiff_t directionX[4] = { 0, 1, 0, -1 };
+	const ptrdiff_t directionY[4] = { -1, 0, 1, 0 };
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	std::pair<size_t, size_t> startCell = maze->getStartCell();
+	std::pair<size_t, size_t> winCell = maze->getWinCell();
+	//Each reached cell records 1 + the direction it was entered by, the start cell records 5
+	cameFrom.assign(maze->getMazeLength(), 0);
+	cameFrom[maze->getCellIndex(startCell.first, startCell.second)] = 5;
+	queue.clear();
+	queue.push_back((uint64_t)startCell.second << 32 | startCell.first);
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		size_t x = (size_t)(queue[head] & 0xFFFFFFFF);
+		size_t y = (size_t)(queue[head] >> 32);
+		if (x == winCell.first && y == winCell.second)
+		{
+			break;
+		}
+		uint8_t cell = maze->getCell(x, y);
+		for (int d = 0; d < 4; d++)
+		{
+			size_t nextX = x + directionX[d];
+			size_t nextY = y + directionY[d];
+			if (nextX >= sizeX || nextY >= sizeY || cameFrom[maze->getCellIndex(nextX, nextY)] != 0)
+			{
+				continue;
+			}
+			//Passages are recorded on one side only
+			if ((cell & (1 << d)) || (maze->getCell(nextX, nextY) & (1 << ((d + 2) & 3))))
+			{
+				cameFrom[maze->getCellIndex(nextX, nextY)] = (uint8_t)(d + 1);
+				queue.push_back((uint64_t)nextY << 32 | nextX);
+			}
+		}
+	}
+	size_t routeLength = 1;
+	size_t x = winCell.first;
+	size_t y = winCell.second;
+	while (cameFrom[maze->getCellIndex(x, y)] >= 1 && cameFrom[maze->getCellIndex(x, y)] <= 4)
+	{
+		int d = cameFrom[maze->getCellIndex(x, y)] - 1;
+		x -= directionX[d];
+		y -= directionY[d];
+		routeLength++;
+	}
+	return routeLength;
+}
+
+//Times scanning every row of a generated maze for walls and dead ends, either with the row kernels
+//or one cell at a time, returning the cells scanned per second. The count stops the work being optimised away
+double benchScan(Maze* maze, bool rows, int repeats, size_t& count)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	std::vector<uint8_t> walls(sizeX);
+	std::vector<size_t> deadEnds;
+	deadEnds.reserve(sizeX);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+	{
+		for (size_t y = 0; y < sizeY; y++)
+		{
+			const uint8_t* row = maze->getMaze() + maze->getCellIndex(0, y);
+			const uint8_t* rowAbove = y > 0 ? row - sizeX : NULL;
+			const uint8_t* rowBelow = y < sizeY - 1 ? row + sizeX : NULL;
+			deadEnds.clear();
+			if (rows)
+			{
+				count += MazeScan::getRowWalls(rowAbove, row, rowBelow, sizeX, walls.data());
+				count += MazeScan::findRowDeadEnds(rowAbove, row, rowBelow, sizeX, deadEnds);
+			}
+			else
+			{
+				for (size_t x = 0; x < sizeX; x++)
+				{
+					walls[x] = MazeScan::getCellWalls(rowAbove, row, rowBelow, x, sizeX);
+					uint8_t exits = MazeScan::getCellExits(rowAbove, row, rowBelow, x, sizeX);
+					if (exits == CELL_PATH_N || exits == CELL_PATH_E || exits == CELL_PATH_S || exits == CELL_PATH_W)
+					{
+						deadEnds.push_back(x);
+					}
+				}
+				count += walls[sizeX - 1] + deadEnds.size();
+			}
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return (double)sizeX * sizeY * repeats / seconds;
+}
+
+//Repeat small mazes so each measurement covers a similar number of cells
+int getRepeats(size_t size, size_t totalCells)
+{
+	return (int)std::max((size_t)1, totalCells / (size * size));
+}
+
+//Microbenchmarks for maze generation. Allocations are reported per generated maze; a count which
+//stays constant as the maze grows shows the generation loop itself does not allocate
+int main(int argc, char** argv)
+{
+	const size_t sizes[] = { 64, 256, 1024, 4096 };
+	std::unique_ptr<MazeGenerator> backtracker(MazeGenerator::create("backtracker"));
+	std::cout << std::setw(8) << "size" << std::setw(10) << "tracked" << std::setw(16) << "cells/s" << std::setw(16) << "allocs/maze" << std::endl;
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		size_t size = sizes[i];
+		int repeats = getRepeats(size, 4096 * 4096 / 4);
+		for (int tracked = 0; tracked < 2; tracked++)
+		{
+			BenchResult result = benchGenerator(backtracker.get(), size, tracked == 1, repeats);
+			double cells = (double)size * size * repeats;
+			std::cout << std::setw(8) << size << std::setw(10) << (tracked ? "yes" : "no") << std::setw(16) << (size_t)(cells / result.seconds)
+				<< std::setw(16) << (double)result.allocations / repeats << std::endl;
+		}
+	}
+
+	//Every algorithm side by side, untracked as in MazeGen. Working memory is the peak heap use
+	//during generation, per cell, not counting the one byte per cell of the maze itself
+	const size_t compareSizes[] = { 256, 1024, 4096 };
+	std::vector<std::string> names = MazeGenerator::getNames();
+	std::cout << std::endl << std::setw(14) << "algorithm" << std::setw(8) << "size" << std::setw(16) << "cells/s"
+		<< std::setw(16) << "bytes/cell" << std::setw(16) << "allocs/maze" << std::endl;
+	for (size_t n = 0; n < names.size(); n++)
+	{
+		std::unique_ptr<MazeGenerator> generator(MazeGenerator::create(names[n]));
+		for (size_t i = 0; i < sizeof(compareSizes) / sizeof(compareSizes[0]); i++)
+		{
+			size_t size = compareSizes[i];
+			int repeats = getRepeats(size, 4096 * 4096);
+			BenchResult result = benchGenerator(generator.get(), size, false, repeats);
+			double cells = (double)size * size * repeats;
+			std::cout << std::setw(14) << names[n] << std::setw(8) << size << std::setw(16) << (size_t)(cells / result.seconds)
+				<< std::setw(16) << std::setprecision(3) << (double)result.peakBytes / ((double)size * size)
+				<< std::setw(16) << (double)result.allocations / repeats << std::endl;
+		}
+	}
+
+	//Parallel Kruskal against the single-threaded backtracker on large mazes, at one thread and at every thread
+	const size_t scalingSizes[] = { 1024, 4096, 16384 };
+	unsigned int hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::cout << std::endl << std::setw(16) << "algorithm" << std::setw(8) << "threads" << std::setw(8) << "size"
+		<< std::setw(16) << "cells/s" << std::setw(16) << "bytes/cell" << std::endl;
+	for (size_t i = 0; i < sizeof(scalingSizes) / sizeof(scalingSizes[0]); i++)
+	{
+		size_t size = scalingSizes[i];
+		int repeats = getRepeats(size, 4096 * 4096);
+		for (int n = 0; n < 3; n++)
+		{
+			unsigned int numThreads = n == 2 ? hardwareThreads : 1;
+			if (n == 2 && hardwareThreads == 1)
+			{
+				continue;
+			}
+			std::unique_ptr<MazeGenerator> generator(n == 0 ? MazeGenerator::create("backtracker") : new ParallelKruskalGenerator(numThreads));
+			BenchResult result = benchGenerator(generator.get(), size, false, repeats);
+			double cells = (double)size * size * repeats;
+			std::cout << std::setw(16) << generator->getName() << std::setw(8) << numThreads << std::setw(8) << size
+				<< std::setw(16) << (size_t)(cells / result.seconds) << std::setw(16) << std::setprecision(3)
+				<< (double)result.peakBytes / ((double)size * size) << std::endl;
+		}
+	}
+
+	//Row kernels for walls and dead ends against the same queries made one cell at a time
+	const size_t scanSizes[] = { 256, 1024, 4096 };
+	std::cout << std::endl << "Scanning with " << MazeScan::getInstructionSet() << std::endl;
+	std::cout << std::setw(8) << "size" << std::setw(16) << "rows cells/s" << std::setw(16) << "cells cells/s" << std::endl;
+	size_t scanCount = 0;
+	for (size_t i = 0; i < sizeof(scanSizes) / sizeof(scanSizes[0]); i++)
+	{
+		size_t size = scanSizes[i];
+		int repeats = getRepeats(size, 4096 * 4096 * 4);
+		Maze maze(size, size, NO_TRACKING);
+		backtracker->generate(&maze, 1);
+		double rowRate = benchScan(&maze, true, repeats, scanCount);
+		double cellRate = benchScan(&maze, false, repeats, scanCount);
+		std::cout << std::setw(8) << size << std::setw(16) << (size_t)rowRate << std::setw(16) << (size_t)cellRate << std::endl;
+	}
+
+	//The row layout against 8x8 tiles on a large maze, for generation and for solving from start to win
+	const char* layoutAlgorithms[] = { "backtracker", "kruskal" };
+	const size_t layoutSize = 4096;
+	std::vector<uint64_t> solveQueue;
+	std::vector<uint8_t> solveCameFrom;
+	solveQueue.reserve(layoutSize * layoutSize);
+	std::cout << std::endl << std::setw(14) << "algorithm" << std::setw(8) << "layout" << std::setw(16) << "gen cells/s"
+		<< std::setw(16) << "solve cells/s" << std::setw(12) << "route" << std::endl;
+	for (size_t n = 0; n < sizeof(layoutAlgorithms) / sizeof(layoutAlgorithms[0]); n++)
+	{
+		std::unique_ptr<MazeGenerator> generator(MazeGenerator::create(layoutAlgorithms[n]));
+		for (int tiles = 0; tiles < 2; tiles++)
+		{
+			MazeLayout layout = tiles ? LAYOUT_TILES : LAYOUT_ROWS;
+			BenchResult result = benchGenerator(generator.get(), layoutSize, false, 1, layout);
+			Maze maze(layoutSize, layoutSize, NO_TRACKING, layout);
+			generator->generate(&maze, 1);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			size_t routeLength = solveMaze(&maze, solveQueue, solveCameFrom);
+			double solveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			double cells = (double)layoutSize * layoutSize;
+			std::cout << std::setw(14) << layoutAlgorithms[n] << std::setw(8) << (tiles ? "tiles" : "rows")
+				<< std::setw(16) << (size_t)(cells / result.seconds) << std::setw(16) << (size_t)(cells / solveSeconds)
+				<< std::setw(12) << routeLength << std::endl;
+		}
+	}
+	return scanCount == 0 ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+#include "MazeFile.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MazeFile::MazeFile()
+{
+	MazeFile::mapping = NULL;
+	MazeFile::mappingLength = 0;
+#ifdef _WIN32
+	MazeFile::fileHandle = INVALID_HANDLE_VALUE;
+	MazeFile::mappingHandle = NULL;
+#endif
+	memset(&header, 0, sizeof(header));
+}
+
+MazeFile::~MazeFile()
+{
+	close();
+}
+
+bool MazeFile::writeHeader(std::ostream& file, size_t sizeX, size_t sizeY, uint64_t seed, std::pair<size_t, size_t> startCell,
+	std::pair<size_t, size_t> winCell, MazeLayout layout, uint64_t dataLength)
+{
+	MazeFileHeader fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	memcpy(fileHeader.magic, "MAZE", 4);
+	fileHeader.version = VERSION;
+	fileHeader.dataOffset = DATA_OFFSET;
+	fileHeader.dataLength = dataLength;
+	fileHeader.sizeX = sizeX;
+	fileHeader.sizeY = sizeY;
+	fileHeader.seed = seed;
+	fileHeader.startX = startCell.first;
+	fileHeader.startY = startCell.second;
+	fileHeader.winX = winCell.first;
+	fileHeader.winY = winCell.second;
+	fileHeader.layout = (uint32_t)layout;
+	std::vector<char> padding(DATA_OFFSET - sizeof(fileHeader), 0);
+	file.write((const char*)&fileHeader, sizeof(fileHeader));
+	file.write(padding.data(), padding.size());
+	return file.good();
+}
+
+bool MazeFile::write(const std::string& path, Maze* maze, uint64_t seed)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	writeHeader(file, maze->getSizeX(), maze->getSizeY(), seed, maze->getStartCell(), maze->getWinCell(), maze->getLayout(), maze->getMazeLength());
+	file.write((const char*)maze->getMaze(), maze->getMazeLength());
+	return file.good();
+}
+
+bool MazeFile::open(const std::string& path, bool writable)
+{
+	close();
+#ifdef _WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER fileSize;
+	if (fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(fileHandle, &fileSize) || (uint64_t)fileSize.QuadPart < sizeof(MazeFileHeader))
+	{
+		close();
+		return false;
+	}
+	mappingLength = (size_t)fileSize.QuadPart;
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+	mapping = mappingHandle != NULL ? MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (mapping == NULL)
+	{
+		close();
+		return false;
+	}
+#else
+	int file = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat fileStatus;
+	if (fstat(file, &fileStatus) != 0 || (uint64_t)fileStatus.st_size < sizeof(MazeFileHeader))
+	{
+		::close(file);
+		return false;
+	}
+	mappingLength = (size_t)fileStatus.st_size;
+	mapping = mmap(NULL, mappingLength, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, file, 0);
+	//The mapping holds its own reference to the file
+	::close(file);
+	if (mapping == MAP_FAILED)
+	{
+		mapping = NULL;
+		mappingLength = 0;
+		return false;
+	}
+#endif
+
+	//Check the header describes cells which are all inside the file before pointing a Maze at them
+	memcpy(&header, mapping, sizeof(header));
+	bool valid = memcmp(header.magic, "MAZE", 4) == 0 && header.version == VERSION && header.layout <= LAYOUT_TILES &&
+		header.dataOffset >= sizeof(header) && header.dataOffset <= mappingLength && header.dataLength <= mappingLength - header.dataOffset &&
+		header.sizeX > 0 && header.sizeY > 0 && header.sizeX <= header.dataLength && header.sizeY <= header.dataLength / header.sizeX &&
+		header.startX < header.sizeX && header.startY < header.sizeY && header.winX < header.sizeX && header.winY < header.sizeY;
+	if (valid)
+	{
+		maze.reset(new Maze((size_t)header.sizeX, (size_t)header.sizeY, (MazeLayout)header.layout, (uint8_t*)mapping + header.dataOffset));
+		valid = maze->getMazeLength() == header.dataLength;
+	}
+	if (!valid)
+	{
+		close();
+		return false;
+	}
+	maze->setStartCell((size_t)header.startX, (size_t)header.startY);
+	maze->setWinCell((size_t)header.winX, (size_t)header.winY);
+	maze->setGenerationComplete();
+	return true;
+}
+
+void MazeFile::close()
+{
+	maze.reset();
+#ifdef _WIN32
+	if (mapping != NULL)
+	{
+		UnmapViewOfFile(mapping);
+	}
+	if (mappingHandle != NULL)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = NULL;
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (mapping != NULL)
+	{
+		munmap(mapping, mappingLength);
+	}
+#endif
+	mapping = NULL;
+	mappingLength = 0;
+}
+
+bool MazeFile::isOpen()
+{
+	return maze.get() != NULL;
+}
+
+Maze* MazeFile::getMaze()
+{
+	return maze.get();
+}
+
+uint64_t MazeFile::getSeed()
+{
+	return header.seed;
+}
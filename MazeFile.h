@@ -0,0 +1,67 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "Maze.h"
+
+//Header at the start of every .maze file. The cells follow at dataOffset, a multiple of the page size,
+//exactly as they are held in memory by a Maze of the same layout, so an opened file needs no conversion.
+//Values are stored in the byte order of the machine which wrote them (little endian on x86 and x64)
+struct MazeFileHeader
+{
+	char magic[4];	//"MAZE"
+	uint32_t version;
+	uint64_t dataOffset;
+	uint64_t dataLength;
+	uint64_t sizeX, sizeY;
+	uint64_t seed;
+	uint64_t startX, startY;
+	uint64_t winX, winY;
+	uint32_t layout;	//A MazeLayout
+	uint32_t reserved;
+};
+
+//Reads and writes .maze files. Opening a file memory maps it and hands out a Maze which reads its cells
+//straight from the mapped pages: nothing is copied, so a maze of any size opens at once, only the pages
+//which are touched are read from disk, and every process opening the same file shares the same memory
+class MazeFile
+{
+private:
+	void* mapping;
+	size_t mappingLength;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+	MazeFileHeader header;
+	std::unique_ptr<Maze> maze;
+public:
+	static const uint32_t VERSION = 1;
+	//Cell data starts on a page boundary, so it can be mapped along with the header and used in place
+	static const uint64_t DATA_OFFSET = 4096;
+
+	MazeFile();
+	~MazeFile();
+
+	//Writes the header padded out to DATA_OFFSET, ready for dataLength bytes of cells to follow
+	static bool writeHeader(std::ostream& file, size_t sizeX, size_t sizeY, uint64_t seed, std::pair<size_t, size_t> startCell,
+		std::pair<size_t, size_t> winCell, MazeLayout layout, uint64_t dataLength);
+	//Writes a whole maze in its own layout
+	static bool write(const std::string& path, Maze* maze, uint64_t seed);
+
+	//Maps a file written by write() or FileRowSink. With writable set, changes made through the Maze are
+	//written back to the file. Returns false if the file is missing, truncated or of another version
+	bool open(const std::string& path, bool writable = false);
+	void close();
+	bool isOpen();
+	//The mapped maze, valid until the file is closed. NULL if no file is open
+	Maze* getMaze();
+	uint64_t getSeed();
+};
+
+#endif
@@ -0,0 +1,362 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EllerGenerator.h"
+#include "FileRowSink.h"
+#include "Maze.h"
+#include "MazeArchive.h"
+#include "MazeFile.h"
+#include "MazeGenerator.h"
+#include "MazeScan.h"
+#include "ParallelKruskalGenerator.h"
+#include "TiledGenerator.h"
+
+//Maps a .maze file and reports what it holds. Opening only reads the header; counting the dead ends then
+//reads every cell, paging the file in as it goes
+int openMaze(const std::string& path)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	MazeFile mazeFile;
+	if (!mazeFile.open(path))
+	{
+		std::cout << "Failed to open " << path << ", or it is not a version " << MazeFile::VERSION << " maze file" << std::endl;
+		return 1;
+	}
+	std::chrono::steady_clock::time_point opened = std::chrono::steady_clock::now();
+	Maze* maze = mazeFile.getMaze();
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	std::cout << "Opened " << sizeX << "x" << sizeY << " maze with seed " << mazeFile.getSeed() << ", stored in "
+		<< (maze->getLayout() == LAYOUT_TILES ? "tiles" : "rows") << ", in " << std::chrono::duration<double>(opened - start).count() << "s" << std::endl;
+	std::cout << "Start: " << maze->getStartCell().first << "," << maze->getStartCell().second
+		<< " win: " << maze->getWinCell().first << "," << maze->getWinCell().second << std::endl;
+
+	std::vector<uint8_t> rowBuffers(3 * sizeX);
+	std::vector<size_t> deadEnds;
+	size_t numDeadEnds = 0;
+	const uint8_t* rows[3];
+	rows[0] = maze->getRow(0, rowBuffers.data());
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		if (y < sizeY - 1)
+		{
+			rows[(y + 1) % 3] = maze->getRow(y + 1, rowBuffers.data() + ((y + 1) % 3) * sizeX);
+		}
+		deadEnds.clear();
+		numDeadEnds += MazeScan::findRowDeadEnds(y > 0 ? rows[(y - 1) % 3] : NULL, rows[y % 3], y < sizeY - 1 ? rows[(y + 1) % 3] : NULL, sizeX, deadEnds);
+	}
+	std::cout << "Dead ends: " << numDeadEnds << ", counted in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - opened).count() << "s" << std::endl;
+	return 0;
+}
+
+//Decodes one region of a maze in an archive, touching only the chunks under it, and draws it in text
+int printRegion(const std::string& path, size_t index, size_t x, size_t y, size_t width, size_t height)
+{
+	MazeArchive archive;
+	MazeArchiveEntry entry;
+	if (!archive.open(path) || !archive.getEntry(index, entry))
+	{
+		std::cout << "Failed to open maze " << index << " of " << path << ", or it is not a version " << MazeArchive::VERSION << " maze archive" << std::endl;
+		return 1;
+	}
+	std::vector<uint8_t> cells(width * height);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!archive.readRegion(index, x, y, width, height, cells.data()))
+	{
+		std::cout << "Region " << width << "x" << height << " at " << x << "," << y << " is not inside the "
+			<< entry.sizeX << "x" << entry.sizeY << " maze" << std::endl;
+		return 1;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	for (size_t cellY = 0; cellY < height; cellY++)
+	{
+		std::string walls = "+";
+		std::string floor = "";
+		for (size_t cellX = 0; cellX < width; cellX++)
+		{
+			uint8_t cell = cells[cellY * width + cellX];
+			walls += (cell & CELL_PATH_N) ? "  +" : "--+";
+			floor += (cell & CELL_PATH_W) ? " " : "|";
+			bool isStart = entry.startX == x + cellX && entry.startY == y + cellY;
+			bool isWin = entry.winX == x + cellX && entry.winY == y + cellY;
+			floor += isStart ? "S " : (isWin ? "W " : "  ");
+		}
+		floor += (cells[cellY * width + width - 1] & CELL_PATH_E) ? " " : "|";
+		std::cout << walls << std::endl << floor << std::endl;
+	}
+	std::string walls = "+";
+	for (size_t cellX = 0; cellX < width; cellX++)
+	{
+		walls += (cells[(height - 1) * width + cellX] & CELL_PATH_S) ? "  +" : "--+";
+	}
+	std::cout << walls << std::endl;
+	std::cout << "Decoded " << width << "x" << height << " cells of the " << entry.sizeX << "x" << entry.sizeY << " maze in " << seconds << "s" << std::endl;
+	return 0;
+}
+
+//Accepts streamed rows without storing them, for measuring generation alone
+class DiscardRowSink : public MazeRowSink
+{
+public:
+	bool writeRow(size_t y, const uint8_t* cells)
+	{
+		return true;
+	}
+};
+
+//Headless maze generation: generates a batch of mazes at full speed, without a window or OpenGL,
+//and reports generation throughput
+int main(int argc, char** argv)
+{
+	size_t sizeX = 128;
+	size_t sizeY = 128;
+	size_t count = 1;
+	uint64_t seed = 0;
+	std::string algorithm = "backtracker";
+	unsigned int numThreads = 0;
+	bool farthest = false;
+	std::string output = "maze";
+	bool write = true;
+	bool stream = false;
+	MazeLayout layout = LAYOUT_ROWS;
+	std::string openPath;
+	std::string archivePath;
+	std::string regionPath;
+	size_t region[5] = { 0, 0, 0, 0, 0 };
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "-width" && i + 1 < argc)
+		{
+			sizeX = std::stoull(argv[++i]);
+		}
+		else if (argument == "-height" && i + 1 < argc)
+		{
+			sizeY = std::stoull(argv[++i]);
+		}
+		else if (argument == "-count" && i + 1 < argc)
+		{
+			count = std::stoull(argv[++i]);
+		}
+		else if (argument == "-seed" && i + 1 < argc)
+		{
+			seed = std::stoull(argv[++i]);
+		}
+		else if (argument == "-algorithm" && i + 1 < argc)
+		{
+			algorithm = argv[++i];
+		}
+		else if (argument == "-farthest")
+		{
+			farthest = true;
+		}
+		else if (argument == "-threads" && i + 1 < argc)
+		{
+			numThreads = (unsigned int)std::stoul(argv[++i]);
+		}
+		else if (argument == "-output" && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if (argument == "-nowrite")
+		{
+			write = false;
+		}
+		else if (argument == "-stream")
+		{
+			stream = true;
+		}
+		else if (argument == "-tiles")
+		{
+			layout = LAYOUT_TILES;
+		}
+		else if (argument == "-open" && i + 1 < argc)
+		{
+			openPath = argv[++i];
+		}
+		else if (argument == "-archive" && i + 1 < argc)
+		{
+			archivePath = argv[++i];
+		}
+		else if (argument == "-region" && i + 6 < argc)
+		{
+			regionPath = argv[++i];
+			for (int j = 0; j < 5; j++)
+			{
+				region[j] = std::stoull(argv[++i]);
+			}
+		}
+		else
+		{
+			std::cout << "Usage: mazegen [-width <x>] [-height <y>] [-count <k>] [-seed <n>] [-algorithm <name>] [-threads <n>] [-farthest] [-output <prefix>] [-nowrite] [-stream] [-tiles] [-open <file>] [-archive <file>] [-region <archive> <index> <x> <y> <w> <h>]" << std::endl;
+			return 1;
+		}
+	}
+	if (!openPath.empty())
+	{
+		return openMaze(openPath);
+	}
+	if (!regionPath.empty())
+	{
+		return printRegion(regionPath, region[0], region[1], region[2], region[3], region[4]);
+	}
+	if (sizeX == 0 || sizeY == 0)
+	{
+		std::cout << "Maze dimensions must be at least 1" << std::endl;
+		return 1;
+	}
+	//Only the tiled and parallel Kruskal generators use more than one thread
+	std::unique_ptr<MazeGenerator> generator;
+	if (algorithm == "tiled")
+	{
+		generator.reset(new TiledGenerator("backtracker", numThreads));
+	}
+	else if (algorithm == "parallelkruskal")
+	{
+		generator.reset(new ParallelKruskalGenerator(numThreads));
+	}
+	else
+	{
+		generator.reset(MazeGenerator::create(algorithm));
+	}
+	if (!generator)
+	{
+		std::cout << "Unknown algorithm " << algorithm << ", choose from:";
+		std::vector<std::string> names = MazeGenerator::getNames();
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			std::cout << " " << names[i];
+		}
+		std::cout << std::endl;
+		return 1;
+	}
+	if (farthest)
+	{
+		generator->setPlacement(MazeGenerator::PLACE_FARTHEST_PAIR);
+	}
+	if (stream && algorithm != "eller")
+	{
+		std::cout << "Only eller can stream rows, use -algorithm eller with -stream" << std::endl;
+		return 1;
+	}
+	//The farthest pair needs the whole maze to search, which streaming never holds
+	if (stream && farthest)
+	{
+		std::cout << "Streamed rows cannot be searched for the farthest pair, leave out -stream to use -farthest" << std::endl;
+		return 1;
+	}
+	//An archive compresses whole mazes, which streaming never holds
+	MazeArchive archive;
+	bool archiving = write && !archivePath.empty();
+	if (archiving && stream)
+	{
+		std::cout << "Streamed rows cannot be archived, leave out -stream to use -archive" << std::endl;
+		return 1;
+	}
+	if (archiving && !archive.create(archivePath))
+	{
+		std::cout << "Failed to create " << archivePath << std::endl;
+		return 1;
+	}
+
+	MazeMetrics totalMetrics = MazeMetrics();
+	double generateSeconds = 0.0;
+	double writeSeconds = 0.0;
+	for (size_t i = 0; i < count; i++)
+	{
+		//Each maze in the batch has its own seed, so any one of them can be reproduced on its own
+		uint64_t mazeSeed = seed + i;
+		std::string path = output + std::to_string(i) + ".maze";
+		if (stream)
+		{
+			//Rows go straight from the generator to the file, so no Maze is ever allocated. Writing
+			//is interleaved with generation, so it is included in the generation time
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			Random random(mazeSeed);
+			bool written = true;
+			if (write)
+			{
+				FileRowSink sink(path, sizeX, sizeY, mazeSeed);
+				written = sink.isOpen() && EllerGenerator::generateRows(sizeX, sizeY, random, sink) && sink.finish();
+			}
+			else
+			{
+				DiscardRowSink sink;
+				EllerGenerator::generateRows(sizeX, sizeY, random, sink);
+			}
+			generateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (!written)
+			{
+				std::cout << "Failed to write " << path << std::endl;
+				return 1;
+			}
+			continue;
+		}
+		//Nothing watches the maze while it generates, so skip recording changes for the renderer
+		Maze maze(sizeX, sizeY, NO_TRACKING, layout);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		generator->generate(&maze, mazeSeed);
+		std::chrono::steady_clock::time_point generated = std::chrono::steady_clock::now();
+		generateSeconds += std::chrono::duration<double>(generated - start).count();
+		MazeMetrics metrics = maze.getMetrics();
+		totalMetrics.routeLength += metrics.routeLength;
+		totalMetrics.numDeadEnds += metrics.numDeadEnds;
+		totalMetrics.numJunctions += metrics.numJunctions;
+		totalMetrics.routeJunctions += metrics.routeJunctions;
+		totalMetrics.branchingFactor += metrics.branchingFactor;
+
+		if (write)
+		{
+			bool written = archiving ? archive.addMaze(&maze, mazeSeed) : MazeFile::write(path, &maze, mazeSeed);
+			if (!written)
+			{
+				std::cout << "Failed to write " << (archiving ? archivePath : path) << std::endl;
+				return 1;
+			}
+			writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - generated).count();
+		}
+	}
+
+	double totalCells = (double)sizeX * (double)sizeY * (double)count;
+	if (archiving)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (!archive.finish())
+		{
+			std::cout << "Failed to write " << archivePath << std::endl;
+			return 1;
+		}
+		writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::ifstream archiveFile(archivePath, std::ios::binary | std::ios::ate);
+		double archiveBytes = (double)archiveFile.tellg();
+		std::cout << "Archive: " << archiveBytes << " bytes, " << archiveBytes * 8.0 / totalCells << " bits per cell" << std::endl;
+	}
+	if (stream)
+	{
+		std::cout << "Maze storage: streamed, one row of " << sizeX << " cells at a time" << std::endl;
+	}
+	else
+	{
+		std::cout << "Maze storage: " << sizeX * sizeY << " bytes per maze" << std::endl;
+	}
+	std::cout << "Generated " << count << " maze(s) of " << sizeX << "x" << sizeY << " with " << algorithm << " in " << generateSeconds << "s" << std::endl;
+	std::cout << "Throughput: " << (generateSeconds > 0.0 ? totalCells / generateSeconds : 0.0) << " cells/s" << std::endl;
+	if (farthest && count > 0)
+	{
+		std::cout << "Mean route length: " << (double)totalMetrics.routeLength / count << " cells, with "
+			<< (double)totalMetrics.routeJunctions / count << " junctions" << std::endl;
+		std::cout << "Mean dead ends: " << (double)totalMetrics.numDeadEnds / count << ", junctions: " << (double)totalMetrics.numJunctions / count << std::endl;
+		std::cout << "Mean branching factor: " << totalMetrics.branchingFactor / count << std::endl;
+	}
+	if (write && !stream)
+	{
+		std::cout << "Writing took " << writeSeconds << "s" << std::endl;
+	}
+	return 0;
+}
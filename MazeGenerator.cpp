@@ -0,0 +1,297 @@
+#include "MazeGenerator.h"
+#include "BacktrackerGenerator.h"
+#include "BinaryTreeGenerator.h"
+#include "EllerGenerator.h"
+#include "GrowingTreeGenerator.h"
+#include "KruskalGenerator.h"
+#include "MazeScan.h"
+#include "ParallelKruskalGenerator.h"
+#include "PrimGenerator.h"
+#include "SidewinderGenerator.h"
+#include "TiledGenerator.h"
+#include "WilsonGenerator.h"
+
+const uint8_t MazeGenerator::NUM_ROUTES[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+const uint8_t MazeGenerator::NTH_ROUTE[16][4] =
+{
+	{ 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 },
+	{ 2, 0, 0, 0 }, { 0, 2, 0, 0 }, { 1, 2, 0, 0 }, { 0, 1, 2, 0 },
+	{ 3, 0, 0, 0 }, { 0, 3, 0, 0 }, { 1, 3, 0, 0 }, { 0, 1, 3, 0 },
+	{ 2, 3, 0, 0 }, { 0, 2, 3, 0 }, { 1, 2, 3, 0 }, { 0, 1, 2, 3 }
+};
+const ptrdiff_t MazeGenerator::DIRECTION_X[4] = { 0, 1, 0, -1 };
+const ptrdiff_t MazeGenerator::DIRECTION_Y[4] = { -1, 0, 1, 0 };
+
+MazeGenerator::MazeGenerator()
+{
+	placement = PLACE_RANDOM_DEAD_ENDS;
+}
+
+MazeGenerator::~MazeGenerator()
+{
+}
+
+void MazeGenerator::setPlacement(Placement placement)
+{
+	MazeGenerator::placement = placement;
+}
+
+void MazeGenerator::generate(Maze* maze, uint64_t seed)
+{
+	if (maze->getSizeX() == 0 || maze->getSizeY() == 0)
+	{
+		return;	//Do not generate a maze as invalid input was used
+	}
+	//Every choice made by this generator comes from its own seeded generators
+	Random random(seed);
+	if (maze->getSizeX() * maze->getSizeY() == 1)
+	{
+		//A single cell has no passages to carve
+		maze->addCellLocation(std::pair<size_t, size_t>(0, 0));
+		maze->setCell(0, 0, CELL_VISITED);
+	}
+	else
+	{
+		carve(maze, random);
+	}
+	if (placement == PLACE_FARTHEST_PAIR)
+	{
+		placeFarthestPair(maze);
+	}
+	else
+	{
+		Random placementRandom(getPlacementSeed(seed));
+		chooseStartAndWin(maze, placementRandom);
+	}
+	maze->setGenerationComplete();
+}
+
+uint64_t MazeGenerator::getPlacementSeed(uint64_t seed)
+{
+	//Mixed rather than offset, so it never matches the seed of another maze in a batch of consecutive seeds
+	return (seed ^ 0xD1B54A32D192ED03ULL) * 0x9E3779B97F4A7C15ULL;
+}
+
+void MazeGenerator::carvePassage(Maze* maze, size_t x, size_t y, uint8_t direction)
+{
+	size_t nextX = x + DIRECTION_X[direction];
+	size_t nextY = y + DIRECTION_Y[direction];
+	uint8_t cell = maze->getCell(x, y);
+	if (!(cell & CELL_VISITED))
+	{
+		maze->addCellLocation(std::pair<size_t, size_t>(x, y));
+	}
+	maze->setCell(x, y, cell | CELL_VISITED | (1 << direction));
+	uint8_t nextCell = maze->getCell(nextX, nextY);
+	if (!(nextCell & CELL_VISITED))
+	{
+		maze->addCellLocation(std::pair<size_t, size_t>(nextX, nextY));
+		maze->setCell(nextX, nextY, nextCell | CELL_VISITED);
+	}
+}
+
+void MazeGenerator::step(Maze* maze, size_t x, size_t y)
+{
+	maze->setCurrentLocation(x, y);
+}
+
+uint8_t MazeGenerator::getNeighbourMask(size_t x, size_t y, size_t sizeX, size_t sizeY)
+{
+	return (uint8_t)((y > 0 ? CELL_PATH_N : 0) | (x < sizeX - 1 ? CELL_PATH_E : 0) |
+		(y < sizeY - 1 ? CELL_PATH_S : 0) | (x > 0 ? CELL_PATH_W : 0));
+}
+
+uint8_t MazeGenerator::chooseRoute(uint8_t routes, Random& random)
+{
+	return NTH_ROUTE[routes][random.nextBelow(NUM_ROUTES[routes])];
+}
+
+uint8_t MazeGenerator::getExits(Maze* maze, size_t x, size_t y)
+{
+	//Passages are recorded on one side only, so a cell's exits are its own paths plus any neighbour's path leading into it
+	uint8_t exits = maze->getCell(x, y) & 0x0F;
+	exits |= (y > 0 && (maze->getCell(x, y - 1) & CELL_PATH_S)) ? CELL_PATH_N : 0;
+	exits |= (x < maze->getSizeX() - 1 && (maze->getCell(x + 1, y) & CELL_PATH_W)) ? CELL_PATH_E : 0;
+	exits |= (y < maze->getSizeY() - 1 && (maze->getCell(x, y + 1) & CELL_PATH_N)) ? CELL_PATH_S : 0;
+	exits |= (x > 0 && (maze->getCell(x - 1, y) & CELL_PATH_E)) ? CELL_PATH_W : 0;
+	return exits;
+}
+
+void MazeGenerator::chooseStartAndWin(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	//Choose a start and end location from the dead ends, sampling two of them in a single pass
+	//so that no list of candidates has to be held for very large mazes. Dead ends are found a row at a time
+	std::pair<size_t, size_t> chosenCells[2];
+	size_t numDeadEnds = 0;
+	std::vector<size_t> rowDeadEnds;
+	rowDeadEnds.reserve(sizeX);
+	//Row y is kept in slot y % 3, so the rows either side of it stay put as it moves down. Rows are only
+	//copied into the buffers when the maze is not stored row by row
+	std::vector<uint8_t> rowBuffers;
+	if (maze->getLayout() != LAYOUT_ROWS)
+	{
+		rowBuffers.assign(3 * sizeX, CELL_NULL);
+	}
+	const uint8_t* rows[3];
+	rows[0] = maze->getRow(0, rowBuffers.data());
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		if (y < sizeY - 1)
+		{
+			rows[(y + 1) % 3] = maze->getRow(y + 1, rowBuffers.data() + ((y + 1) % 3) * sizeX);
+		}
+		rowDeadEnds.clear();
+		MazeScan::findRowDeadEnds(y > 0 ? rows[(y - 1) % 3] : NULL, rows[y % 3], y < sizeY - 1 ? rows[(y + 1) % 3] : NULL, sizeX, rowDeadEnds);
+		for (size_t i = 0; i < rowDeadEnds.size(); i++)
+		{
+			size_t slot = numDeadEnds < 2 ? numDeadEnds : random.nextBelow(numDeadEnds + 1);
+			if (slot < 2)
+			{
+				chosenCells[slot] = std::pair<size_t, size_t>(rowDeadEnds[i], y);
+			}
+			numDeadEnds++;
+		}
+	}
+	if (numDeadEnds >= 2)
+	{
+		maze->setStartCell(chosenCells[0].first, chosenCells[0].second);
+		maze->setWinCell(chosenCells[1].first, chosenCells[1].second);
+	}
+	else
+	{
+		maze->setStartCell(0, 0);
+		maze->setWinCell(sizeX - 1, sizeY - 1);
+	}
+}
+
+//Breadth first search of the maze from firstCell, leaving every cell in the queue in the order it was reached,
+//each as (cell number << 2 | direction it was entered by), with cells numbered row by row. A perfect maze is a
+//tree, so skipping the way back is enough to never reach a cell twice, and no visited set is needed.
+//Returns the number of the last cell reached, which is one of those furthest from firstCell
+size_t MazeGenerator::traverse(Maze* maze, size_t firstCell, std::vector<uint64_t>& queue, MazeMetrics* metrics)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t head = 0;
+	size_t tail = 0;
+	queue[tail++] = (uint64_t)firstCell << 2;
+	while (head < tail)
+	{
+		uint64_t entry = queue[head];
+		size_t cellNumber = (size_t)(entry >> 2);
+		size_t x = cellNumber % sizeX;
+		size_t y = cellNumber / sizeX;
+		uint8_t exits = getExits(maze, x, y);
+		if (metrics != NULL)
+		{
+			metrics->numDeadEnds += NUM_ROUTES[exits] == 1 ? 1 : 0;
+			metrics->numJunctions += NUM_ROUTES[exits] >= 3 ? 1 : 0;
+		}
+		if (head > 0)
+		{
+			//Do not go back the way this cell was entered
+			exits &= ~(1 << (((entry & 0x03) + 2) & 0x03));
+		}
+		for (uint8_t direction = 0; direction < 4; direction++)
+		{
+			if (exits & (1 << direction))
+			{
+				size_t next = (y + DIRECTION_Y[direction]) * sizeX + x + DIRECTION_X[direction];
+				queue[tail++] = ((uint64_t)next << 2) | direction;
+			}
+		}
+		head++;
+	}
+	return (size_t)(queue[tail - 1] >> 2);
+}
+
+//Places the start and win cells at the two ends of the longest route through the maze. In a tree the cell
+//furthest from any cell is one end of a longest route, and the cell furthest from that is the other
+void MazeGenerator::placeFarthestPair(Maze* maze)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t numCells = sizeX * maze->getSizeY();
+	//One queue holds every cell, and is shared by both searches and the metrics
+	std::vector<uint64_t> queue(numCells);
+	size_t start = traverse(maze, 0, queue, NULL);
+	MazeMetrics metrics = MazeMetrics();
+	size_t win = traverse(maze, start, queue, &metrics);
+
+	//Walk the route back from win to start. Each cell's entry direction gives its parent, which was
+	//queued earlier, so a single backwards scan of the queue finds every cell on the route
+	size_t position = numCells - 1;
+	size_t cellNumber = win;
+	uint64_t waysForward = 0;
+	metrics.routeLength = 1;
+	while (position > 0)
+	{
+		uint8_t enteredBy = queue[position] & 0x03;
+		size_t parent = cellNumber - DIRECTION_X[enteredBy] - DIRECTION_Y[enteredBy] * (ptrdiff_t)sizeX;
+		while ((size_t)(queue[position] >> 2) != parent)
+		{
+			position--;
+		}
+		//Every exit out of a cell on the route is a way forward, apart from the one it was entered by
+		uint8_t numExits = NUM_ROUTES[getExits(maze, parent % sizeX, parent / sizeX)];
+		waysForward += position > 0 ? numExits - 1 : numExits;
+		metrics.routeJunctions += numExits >= 3 ? 1 : 0;
+		metrics.routeLength++;
+		cellNumber = parent;
+	}
+	metrics.branchingFactor = metrics.routeLength > 1 ? (double)waysForward / (double)(metrics.routeLength - 1) : 0.0;
+
+	maze->setStartCell(start % sizeX, start / sizeX);
+	maze->setWinCell(win % sizeX, win / sizeX);
+	maze->setMetrics(metrics);
+}
+
+MazeGenerator* MazeGenerator::create(const std::string& name)
+{
+	if (name == "backtracker")
+	{
+		return new BacktrackerGenerator();
+	}
+	if (name == "kruskal")
+	{
+		return new KruskalGenerator();
+	}
+	if (name == "parallelkruskal")
+	{
+		return new ParallelKruskalGenerator();
+	}
+	if (name == "prim")
+	{
+		return new PrimGenerator();
+	}
+	if (name == "wilson")
+	{
+		return new WilsonGenerator();
+	}
+	if (name == "eller")
+	{
+		return new EllerGenerator();
+	}
+	if (name == "growingtree")
+	{
+		return new GrowingTreeGenerator();
+	}
+	if (name == "binarytree")
+	{
+		return new BinaryTreeGenerator();
+	}
+	if (name == "sidewinder")
+	{
+		return new SidewinderGenerator();
+	}
+	if (name == "tiled")
+	{
+		return new TiledGenerator();
+	}
+	return NULL;
+}
+
+std::vector<std::string> MazeGenerator::getNames()
+{
+	return { "backtracker", "kruskal", "parallelkruskal", "prim", "wilson", "eller", "growingtree", "binarytree", "sidewinder", "tiled" };
+}
@@ -0,0 +1,76 @@
+#ifndef MAZE_GENERATOR_H
+#define MAZE_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Maze.h"
+#include "Random.h"
+
+//Base class for the maze generation algorithms. Every engine writes the same CELL_PATH_* encoding into
+//the maze, recording each passage on one side only, so the renderer and tools work with any of them
+class MazeGenerator
+{
+	//Runs other engines on each of its tiles
+	friend class TiledGenerator;
+	//Hands mazes too large for its disjoint set to TiledGenerator
+	friend class ParallelKruskalGenerator;
+
+protected:
+	//For a 4-bit mask of directions: how many are set, and the position of the n-th set bit.
+	//With only 16 masks a table replaces popcount and pdep, and works on any CPU
+	static const uint8_t NUM_ROUTES[16];
+	static const uint8_t NTH_ROUTE[16][4];
+	//Movement in each direction (N, E, S & W), numbered so that (1 << direction) is the CELL_PATH_* bit
+	static const ptrdiff_t DIRECTION_X[4];
+	static const ptrdiff_t DIRECTION_Y[4];
+
+	//Generates the maze itself, every cell must be visited when this returns
+	virtual void carve(Maze* maze, Random& random) = 0;
+
+	//Opens a passage from (x, y) in the given direction, marking both cells as visited
+	void carvePassage(Maze* maze, size_t x, size_t y, uint8_t direction);
+	//Records the cell being worked on
+	void step(Maze* maze, size_t x, size_t y);
+	//Mask of the directions which stay inside the maze from (x, y)
+	static uint8_t getNeighbourMask(size_t x, size_t y, size_t sizeX, size_t sizeY);
+	//Picks one of the directions set in a non-empty mask
+	static uint8_t chooseRoute(uint8_t routes, Random& random);
+	//Mask of the passages out of (x, y), counting those recorded by its neighbours
+	static uint8_t getExits(Maze* maze, size_t x, size_t y);
+public:
+	//How generate() places the start and win cells
+	enum Placement
+	{
+		PLACE_RANDOM_DEAD_ENDS,	//Two dead ends chosen at random, which may be close together
+		PLACE_FARTHEST_PAIR	//The two ends of the longest route through the maze, also fills in the maze's metrics
+	};
+private:
+	Placement placement;
+
+	void chooseStartAndWin(Maze* maze, Random& random);
+	void placeFarthestPair(Maze* maze);
+	size_t traverse(Maze* maze, size_t firstCell, std::vector<uint64_t>& queue, MazeMetrics* metrics);
+public:
+	MazeGenerator();
+	virtual ~MazeGenerator();
+
+	void setPlacement(Placement placement);
+
+	//Name used to select this algorithm at runtime
+	virtual std::string getName() = 0;
+	//Generates a maze at full speed, then places its start and win cells. Watching
+	//generation is left to the reader of the maze's event log, which can replay it at any pace
+	void generate(Maze* maze, uint64_t seed);
+
+	//Seed of the stream which places the start and win at random dead ends. It is separate from the stream
+	//which carves the maze, so a sink sampling dead ends while rows are streamed makes the same choices
+	static uint64_t getPlacementSeed(uint64_t seed);
+
+	//Creates the engine with the given name, or returns NULL if there is no such engine
+	static MazeGenerator* create(const std::string& name);
+	static std::vector<std::string> getNames();
+};
+
+#endif
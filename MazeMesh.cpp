@@ -0,0 +1,355 @@
+#include "MazeMesh.h"
+#include <algorithm>
+
+const size_t MazeMesh::CHUNK_CELLS;
+
+MazeMesh::MazeMesh(CompactMaze& maze, float cellWidth, float wallHeight, float wallThickness, GLuint floorTexture, GLuint wallTexture)
+{
+	MazeMesh::floorTexture = floorTexture;
+	MazeMesh::wallTexture = wallTexture;
+	MazeMesh::cellWidth = cellWidth;
+	MazeMesh::wallHeight = wallHeight;
+	MazeMesh::wallThickness = wallThickness;
+	MazeMesh::numWalls = 0;
+	MazeMesh::numWallRuns = 0;
+	MazeMesh::numChunksCulled = 0;
+	MazeMesh::numChunksHidden = 0;
+	MazeMesh::stamp = 0;
+	MazeMesh::uniformProgramId = 0;
+
+	size_t sizeX = maze.getSizeX();
+	size_t sizeY = maze.getSizeY();
+	MazeMesh::sizeX = sizeX;
+	MazeMesh::chunksX = (sizeX + CHUNK_CELLS - 1) / CHUNK_CELLS;
+	for (size_t y = 0; y < sizeY; y += CHUNK_CELLS)
+	{
+		for (size_t x = 0; x < sizeX; x += CHUNK_CELLS)
+		{
+			addChunk(maze, x, y, std::min(x + CHUNK_CELLS, sizeX), std::min(y + CHUNK_CELLS, sizeY));
+		}
+	}
+
+	chunkStamps.assign(chunks.size(), 0);
+	setupMesh();
+}
+
+MazeMesh::~MazeMesh()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+}
+
+//Adds two triangles, with the corners given anticlockwise as seen from the side the normal points to
+void MazeMesh::addQuad(glm::vec3 corners[4], glm::vec3 normal, glm::vec2 texCoords[4], MazeSurface surface)
+{
+	unsigned int first = (unsigned int)vertices.size();
+	for (int i = 0; i < 4; i++)
+	{
+		MazeVertex vertex;
+		vertex.Position = corners[i];
+		vertex.Normal = normal;
+		vertex.TexCoords = texCoords[i];
+		vertex.Surface = (float)surface;
+		vertices.push_back(vertex);
+	}
+	const unsigned int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int i = 0; i < 6; i++)
+	{
+		indices.push_back(first + quadIndices[i]);
+	}
+}
+
+//Adds the sides, ends and top of one run of walls. The bottom rests on the floor and is never seen. Sides and
+//ends repeat the wall texture once per cell along their length, and the top is mapped from above, so the tops
+//of runs which cross at a corner show the same texels and do not flicker
+void MazeMesh::addWallRun(glm::vec3 minCorner, glm::vec3 maxCorner)
+{
+	float x0 = minCorner.x, y0 = minCorner.y, z0 = minCorner.z;
+	float x1 = maxCorner.x, y1 = maxCorner.y, z1 = maxCorner.z;
+	float lengthX = (x1 - x0) / cellWidth;
+	float lengthZ = (z1 - z0) / cellWidth;
+
+	glm::vec3 south[4] = { glm::vec3(x0, y0, z1), glm::vec3(x1, y0, z1), glm::vec3(x1, y1, z1), glm::vec3(x0, y1, z1) };
+	glm::vec3 north[4] = { glm::vec3(x1, y0, z0), glm::vec3(x0, y0, z0), glm::vec3(x0, y1, z0), glm::vec3(x1, y1, z0) };
+	glm::vec2 alongX[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(lengthX, 0.0f), glm::vec2(lengthX, 1.0f), glm::vec2(0.0f, 1.0f) };
+	addQuad(south, glm::vec3(0.0f, 0.0f, 1.0f), alongX, SURFACE_WALL);
+	addQuad(north, glm::vec3(0.0f, 0.0f, -1.0f), alongX, SURFACE_WALL);
+
+	glm::vec3 east[4] = { glm::vec3(x1, y0, z1), glm::vec3(x1, y0, z0), glm::vec3(x1, y1, z0), glm::vec3(x1, y1, z1) };
+	glm::vec3 west[4] = { glm::vec3(x0, y0, z0), glm::vec3(x0, y0, z1), glm::vec3(x0, y1, z1), glm::vec3(x0, y1, z0) };
+	glm::vec2 alongZ[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(lengthZ, 0.0f), glm::vec2(lengthZ, 1.0f), glm::vec2(0.0f, 1.0f) };
+	addQuad(east, glm::vec3(1.0f, 0.0f, 0.0f), alongZ, SURFACE_WALL);
+	addQuad(west, glm::vec3(-1.0f, 0.0f, 0.0f), alongZ, SURFACE_WALL);
+
+	glm::vec3 top[4] = { glm::vec3(x0, y1, z1), glm::vec3(x1, y1, z1), glm::vec3(x1, y1, z0), glm::vec3(x0, y1, z0) };
+	glm::vec2 topTexCoords[4] = {
+		glm::vec2(x0 / cellWidth, z1 / cellWidth),
+		glm::vec2(x1 / cellWidth, z1 / cellWidth),
+		glm::vec2(x1 / cellWidth, z0 / cellWidth),
+		glm::vec2(x0 / cellWidth, z0 / cellWidth)
+	};
+	addQuad(top, glm::vec3(0.0f, 1.0f, 0.0f), topTexCoords, SURFACE_WALL);
+	numWallRuns++;
+}
+
+//Adds a wall run for every unbroken stretch of walls along one grid line, where walled holds one entry per edge
+//from the edge at start, followed by one clear entry to end the last run
+void MazeMesh::addLineRuns(const std::vector<uint8_t>& walled, size_t start, float lineOffset, float originAlong, bool alongX)
+{
+	float halfThickness = wallThickness / 2;
+	size_t runStart = 0;
+	for (size_t i = 0; i < walled.size(); i++)
+	{
+		if (walled[i])
+		{
+			continue;
+		}
+		if (i > runStart)
+		{
+			float from = originAlong + (float)(start + runStart) * cellWidth - halfThickness;
+			float to = originAlong + (float)(start + i) * cellWidth + halfThickness;
+			if (alongX)
+			{
+				addWallRun(glm::vec3(from, 0.0f, lineOffset - halfThickness), glm::vec3(to, wallHeight, lineOffset + halfThickness));
+			}
+			else
+			{
+				addWallRun(glm::vec3(lineOffset - halfThickness, 0.0f, from), glm::vec3(lineOffset + halfThickness, wallHeight, to));
+			}
+			numWalls += i - runStart;
+		}
+		runStart = i + 1;
+	}
+}
+
+//Adds the floor and walls of cells x0 to x1 - 1 and y0 to y1 - 1 as the next chunk. Horizontal lines run along x
+//at the north edge of each row, vertical lines along z at the west edge of each column, and the chunks along the
+//south and east of the maze also take its last line. The edges of the maze are always walled
+void MazeMesh::addChunk(CompactMaze& maze, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+	size_t sizeX = maze.getSizeX();
+	size_t sizeY = maze.getSizeY();
+	float originX = -(float)sizeX * cellWidth / 2;
+	float originZ = -(float)sizeY * cellWidth / 2;
+	MazeMeshChunk chunk;
+	chunk.firstIndex = indices.size();
+	size_t firstVertex = vertices.size();
+
+	float floorX0 = originX + (float)x0 * cellWidth;
+	float floorX1 = originX + (float)x1 * cellWidth;
+	float floorZ0 = originZ + (float)y0 * cellWidth;
+	float floorZ1 = originZ + (float)y1 * cellWidth;
+	glm::vec3 floorCorners[4] = {
+		glm::vec3(floorX0, 0.0f, floorZ1),
+		glm::vec3(floorX1, 0.0f, floorZ1),
+		glm::vec3(floorX1, 0.0f, floorZ0),
+		glm::vec3(floorX0, 0.0f, floorZ0)
+	};
+	glm::vec2 floorTexCoords[4] = {
+		glm::vec2((float)x0, (float)y1),
+		glm::vec2((float)x1, (float)y1),
+		glm::vec2((float)x1, (float)y0),
+		glm::vec2((float)x0, (float)y0)
+	};
+	addQuad(floorCorners, glm::vec3(0.0f, 1.0f, 0.0f), floorTexCoords, SURFACE_FLOOR);
+
+	std::vector<uint8_t> walled;
+	for (size_t line = y0; line < (y1 == sizeY ? y1 + 1 : y1); line++)
+	{
+		walled.assign(x1 - x0 + 1, 0);
+		const uint64_t* southWalls = line > 0 && line < sizeY ? maze.getSouthWalls(line - 1) : NULL;
+		for (size_t x = x0; x < x1; x++)
+		{
+			walled[x - x0] = southWalls == NULL || (southWalls[x / 64] & (1ULL << (x % 64))) != 0;
+		}
+		addLineRuns(walled, x0, originZ + (float)line * cellWidth, originX, true);
+	}
+	for (size_t line = x0; line < (x1 == sizeX ? x1 + 1 : x1); line++)
+	{
+		walled.assign(y1 - y0 + 1, 0);
+		for (size_t y = y0; y < y1; y++)
+		{
+			walled[y - y0] = line == 0 || line == sizeX || (maze.getEastWalls(y)[(line - 1) / 64] & (1ULL << ((line - 1) % 64))) != 0;
+		}
+		addLineRuns(walled, y0, originX + (float)line * cellWidth, originZ, false);
+	}
+
+	chunk.numIndices = indices.size() - chunk.firstIndex;
+	chunk.minCorner = vertices[firstVertex].Position;
+	chunk.maxCorner = vertices[firstVertex].Position;
+	for (size_t i = firstVertex + 1; i < vertices.size(); i++)
+	{
+		const glm::vec3& position = vertices[i].Position;
+		chunk.minCorner = glm::vec3(std::min(chunk.minCorner.x, position.x), std::min(chunk.minCorner.y, position.y), std::min(chunk.minCorner.z, position.z));
+		chunk.maxCorner = glm::vec3(std::max(chunk.maxCorner.x, position.x), std::max(chunk.maxCorner.y, position.y), std::max(chunk.maxCorner.z, position.z));
+	}
+	chunks.push_back(chunk);
+}
+
+void MazeMesh::setupMesh()
+{
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+
+	glBindVertexArray(VAO);
+
+	//The maze never changes once baked, so both buffers are uploaded once
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MazeVertex), vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+	//Same locations as Mesh, with the surface after the instance matrix at 3-6
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MazeVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MazeVertex), (void*)offsetof(MazeVertex, Normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MazeVertex), (void*)offsetof(MazeVertex, TexCoords));
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(MazeVertex), (void*)offsetof(MazeVertex, Surface));
+
+	glBindVertexArray(0);
+}
+
+//Adds a chunk to those holding visible cells, unless it was already added this frame
+void MazeMesh::markVisibleChunk(size_t chunk)
+{
+	if (chunkStamps[chunk] != stamp)
+	{
+		chunkStamps[chunk] = stamp;
+		visibleChunks.push_back(chunk);
+	}
+}
+
+//Adds a chunk to the ranges to draw, joining it onto the last range if it follows on from it
+void MazeMesh::addDrawRange(const MazeMeshChunk& chunk)
+{
+	if (!drawCounts.empty() && (size_t)drawOffsets.back() / sizeof(unsigned int) + drawCounts.back() == chunk.firstIndex)
+	{
+		drawCounts.back() += (GLsizei)chunk.numIndices;
+	}
+	else
+	{
+		drawCounts.push_back((GLsizei)chunk.numIndices);
+		drawOffsets.push_back((const void*)(chunk.firstIndex * sizeof(unsigned int)));
+	}
+}
+
+//Draws the chunks which may be visible in one call, with the floor texture on unit 0 as material.diffuseMap and the
+//wall texture on unit 1. Chunks are stored in rows, and taken in that order, so neighbouring chunks share a range
+void MazeMesh::Draw(Shader& shader, const glm::mat4& viewProjection, const std::vector<size_t>* visibleCells)
+{
+	Frustum frustum(viewProjection);
+	drawCounts.clear();
+	drawOffsets.clear();
+	numChunksCulled = 0;
+	numChunksHidden = 0;
+	if (visibleCells != NULL)
+	{
+		stamp++;
+		if (stamp == 0)
+		{
+			std::fill(chunkStamps.begin(), chunkStamps.end(), 0);
+			stamp = 1;
+		}
+		visibleChunks.clear();
+		size_t chunksY = chunks.size() / chunksX;
+		for (size_t i = 0; i < visibleCells->size(); i++)
+		{
+			size_t cellIndex = (*visibleCells)[i];
+			size_t x = cellIndex % sizeX;
+			size_t y = cellIndex / sizeX;
+			size_t chunkX = x / CHUNK_CELLS;
+			size_t chunkY = y / CHUNK_CELLS;
+			markVisibleChunk(chunkY * chunksX + chunkX);
+			//A chunk only holds the lines on its north and west sides, so the east and south walls of cells
+			//on its far edges belong to the next chunk over
+			if (x % CHUNK_CELLS == CHUNK_CELLS - 1 && chunkX + 1 < chunksX)
+			{
+				markVisibleChunk(chunkY * chunksX + chunkX + 1);
+			}
+			if (y % CHUNK_CELLS == CHUNK_CELLS - 1 && chunkY + 1 < chunksY)
+			{
+				markVisibleChunk((chunkY + 1) * chunksX + chunkX);
+			}
+		}
+		std::sort(visibleChunks.begin(), visibleChunks.end());
+		numChunksHidden = chunks.size() - visibleChunks.size();
+	}
+	size_t numCandidates = visibleCells != NULL ? visibleChunks.size() : chunks.size();
+	for (size_t i = 0; i < numCandidates; i++)
+	{
+		const MazeMeshChunk& chunk = chunks[visibleCells != NULL ? visibleChunks[i] : i];
+		if (frustum.intersectsBox(chunk.minCorner, chunk.maxCorner))
+		{
+			addDrawRange(chunk);
+		}
+		else
+		{
+			numChunksCulled++;
+		}
+	}
+	if (drawCounts.empty())
+	{
+		return;
+	}
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, floorTexture);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, wallTexture);
+	glActiveTexture(GL_TEXTURE0);
+	if (shader.getProgramId() != uniformProgramId)
+	{
+		uniformProgramId = shader.getProgramId();
+		wallMapUniform = shader.getUniform<int>("wallMap");
+		instancedUniform = shader.getUniform<bool>("instanced");
+		modelMatrixUniform = shader.getUniform<glm::mat4>("modelMatrix");
+	}
+	wallMapUniform.set(1);
+	instancedUniform.set(false);
+	modelMatrixUniform.set(glm::mat4(1.0f));
+
+	glBindVertexArray(VAO);
+	glMultiDrawElements(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(), (GLsizei)drawCounts.size());
+	glBindVertexArray(0);
+}
+
+size_t MazeMesh::getNumWalls()
+{
+	return numWalls;
+}
+
+size_t MazeMesh::getNumWallRuns()
+{
+	return numWallRuns;
+}
+
+size_t MazeMesh::getNumTriangles()
+{
+	return indices.size() / 3;
+}
+
+const std::vector<MazeMeshChunk>& MazeMesh::getChunks()
+{
+	return chunks;
+}
+
+//Counts the chunks drawn, not the ranges they were joined into
+size_t MazeMesh::getNumChunksDrawn()
+{
+	return chunks.size() - numChunksCulled - numChunksHidden;
+}
+
+size_t MazeMesh::getNumChunksCulled()
+{
+	return numChunksCulled;
+}
+
+size_t MazeMesh::getNumChunksHidden()
+{
+	return numChunksHidden;
+}
@@ -0,0 +1,96 @@
+#ifndef MAZE_MESH_H
+#define MAZE_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+#include "CompactMaze.h"
+#include "Frustum.h"
+#include "Shader.h"
+
+//Which texture a vertex of a MazeMesh is drawn with
+enum MazeSurface
+{
+	SURFACE_FLOOR = 0,
+	SURFACE_WALL = 1
+};
+
+struct MazeVertex {
+	glm::vec3 Position;
+	glm::vec3 Normal;
+	glm::vec2 TexCoords;
+	float Surface;	//A MazeSurface, read by the shader to pick the floor or wall texture
+};
+
+//A square of cells of a MazeMesh: the range of the index buffer holding its floor and walls, and the box around them
+struct MazeMeshChunk {
+	size_t firstIndex;
+	size_t numIndices;
+	glm::vec3 minCorner;
+	glm::vec3 maxCorner;
+};
+
+//A finished maze baked into one static vertex and index buffer. The floor is one quad per chunk, and every
+//straight run of walls along a grid line becomes one long box rather than a model per wall, so a corridor of any
+//length costs the same number of triangles as a single wall. The maze is cut into chunks of CHUNK_CELLS x
+//CHUNK_CELLS cells, each a contiguous range of indices with its own bounding box; runs are split where they
+//cross into the next chunk. Drawing skips the chunks outside the camera's frustum, and optionally those holding
+//no cell the camera can see, and draws the rest in a single call. The mesh is centred on the origin like the instanced floors and walls, and its textures repeat once per cell
+class MazeMesh
+{
+private:
+	GLuint VAO, VBO, EBO;
+	GLuint floorTexture, wallTexture;
+	float cellWidth, wallHeight, wallThickness;
+	size_t numWalls;
+	size_t numWallRuns;
+	std::vector<MazeMeshChunk> chunks;
+	size_t sizeX, chunksX;
+	//Chunks holding visible cells, each listed once by marking it with the frame's stamp
+	std::vector<size_t> visibleChunks;
+	std::vector<uint32_t> chunkStamps;
+	uint32_t stamp;
+	//Index counts and byte offsets of the chunks drawn last frame, as glMultiDrawElements takes them
+	std::vector<GLsizei> drawCounts;
+	std::vector<const void*> drawOffsets;
+	size_t numChunksCulled;
+	size_t numChunksHidden;
+	//Uniforms of the shader last drawn with, looked up again only when the shader changes
+	GLuint uniformProgramId;
+	Uniform<int> wallMapUniform;
+	Uniform<bool> instancedUniform;
+	Uniform<glm::mat4> modelMatrixUniform;
+
+	void markVisibleChunk(size_t chunk);
+	void addDrawRange(const MazeMeshChunk& chunk);
+
+	void addQuad(glm::vec3 corners[4], glm::vec3 normal, glm::vec2 texCoords[4], MazeSurface surface);
+	void addWallRun(glm::vec3 minCorner, glm::vec3 maxCorner);
+	void addLineRuns(const std::vector<uint8_t>& walled, size_t start, float lineOffset, float originAlong, bool alongX);
+	void addChunk(CompactMaze& maze, size_t x0, size_t y0, size_t x1, size_t y1);
+	void setupMesh();
+public:
+	static const size_t CHUNK_CELLS = 16;
+
+	std::vector<MazeVertex> vertices;
+	std::vector<unsigned int> indices;
+
+	MazeMesh(CompactMaze& maze, float cellWidth, float wallHeight, float wallThickness, GLuint floorTexture, GLuint wallTexture);
+	~MazeMesh();
+	//Draws every chunk which may be visible through viewProjection. If visibleCells is given, as indices
+	//y * sizeX + x, only the chunks holding those cells or their walls are considered, and the rest are not looked at
+	void Draw(Shader& shader, const glm::mat4& viewProjection, const std::vector<size_t>* visibleCells = NULL);
+
+	//Walls in the maze, and the runs they were merged into
+	size_t getNumWalls();
+	size_t getNumWallRuns();
+	size_t getNumTriangles();
+	const std::vector<MazeMeshChunk>& getChunks();
+	//Chunks drawn by the last call to Draw(), those outside the frustum, and those holding no visible cells
+	size_t getNumChunksDrawn();
+	size_t getNumChunksCulled();
+	size_t getNumChunksHidden();
+};
+
+#endif
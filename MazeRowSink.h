@@ -0,0 +1,18 @@
+#ifndef MAZE_ROW_SINK_H
+#define MAZE_ROW_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+
+//Receives a maze one finished row at a time from a streaming generator, so the whole maze never
+//has to be held in memory. Rows arrive in order from y = 0, each sizeX cells in the CELL_* encoding
+class MazeRowSink
+{
+public:
+	virtual ~MazeRowSink() {}
+
+	//Returning false stops generation, for example when a write fails
+	virtual bool writeRow(size_t y, const uint8_t* cells) = 0;
+};
+
+#endif
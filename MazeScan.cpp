@@ -0,0 +1,259 @@
+#include "MazeScan.h"
+#include "Maze.h"
+
+//AVX2 needs /arch:AVX2 or -mavx2. SSE2 is always there on x64, and on x86 with /arch:SSE2 or -msse2
+#if defined(__AVX2__)
+#define MAZE_SCAN_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAZE_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	struct RowCounts
+	{
+		size_t numWalls;
+		size_t numDeadEnds;
+	};
+
+	//Every kernel works on the same bit tricks: a neighbour's path towards a cell sits two bits away from the
+	//cell's path towards the neighbour (N = 1 and S = 4, E = 2 and W = 8), so shifting the neighbour's byte
+	//by two moves it onto the right bit, and the neighbour's CELL_VISITED bit can be shifted the same way
+	uint8_t cellExits(uint8_t cell, uint8_t above, uint8_t right, uint8_t below, uint8_t left)
+	{
+		return (uint8_t)((cell & 0x0F) | ((above >> 2) & CELL_PATH_N) | ((right >> 2) & CELL_PATH_E) |
+			((below << 2) & CELL_PATH_S) | ((left << 2) & CELL_PATH_W));
+	}
+
+	//A wall is needed if either side has been generated and neither side has a path through it
+	uint8_t cellWalls(uint8_t cell, uint8_t above, uint8_t right, uint8_t below, uint8_t left)
+	{
+		uint8_t generated = (cell & CELL_VISITED) ? 0x0F : (uint8_t)(((above >> 4) & CELL_PATH_N) | ((right >> 3) & CELL_PATH_E) |
+			((below >> 2) & CELL_PATH_S) | ((left >> 1) & CELL_PATH_W));
+		return generated & ~cellExits(cell, above, right, below, left) & 0x0F;
+	}
+
+	int countDirections(uint8_t directions)
+	{
+		return (directions & 1) + ((directions >> 1) & 1) + ((directions >> 2) & 1) + ((directions >> 3) & 1);
+	}
+
+	//Scans one cell, for the edges of the row and whatever is left over after the vector loop
+	void scanCell(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX,
+		uint8_t wallCountMask, uint8_t* exits, uint8_t* walls, std::vector<size_t>* deadEnds, RowCounts& counts)
+	{
+		uint8_t cell = row[x];
+		uint8_t above = rowAbove != NULL ? rowAbove[x] : (uint8_t)CELL_NULL;
+		uint8_t below = rowBelow != NULL ? rowBelow[x] : (uint8_t)CELL_NULL;
+		uint8_t left = x > 0 ? row[x - 1] : (uint8_t)CELL_NULL;
+		uint8_t right = x < sizeX - 1 ? row[x + 1] : (uint8_t)CELL_NULL;
+		uint8_t thisExits = cellExits(cell, above, right, below, left);
+		if (exits != NULL)
+		{
+			exits[x] = thisExits;
+		}
+		if (walls != NULL)
+		{
+			walls[x] = cellWalls(cell, above, right, below, left);
+			counts.numWalls += countDirections(walls[x] & (x == sizeX - 1 ? wallCountMask | CELL_PATH_E : wallCountMask));
+		}
+		if (deadEnds != NULL && countDirections(thisExits) == 1)
+		{
+			deadEnds->push_back(x);
+			counts.numDeadEnds++;
+		}
+	}
+
+#if defined(MAZE_SCAN_AVX2)
+	struct Isa
+	{
+		typedef __m256i Vector;
+		static const size_t WIDTH = 32;
+		static Vector load(const uint8_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+		static void store(uint8_t* p, Vector v) { _mm256_storeu_si256((__m256i*)p, v); }
+		static Vector zero() { return _mm256_setzero_si256(); }
+		static Vector set(uint8_t value) { return _mm256_set1_epi8((char)value); }
+		static Vector bitAnd(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+		static Vector bitOr(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+		static Vector andNot(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+		static Vector addBytes(Vector a, Vector b) { return _mm256_add_epi8(a, b); }
+		static Vector equalBytes(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+		//There are no byte shifts, so shift 16-bit lanes; bits crossing into the other byte are masked off by every caller
+		template <int SHIFT> static Vector shiftRight(Vector v) { return _mm256_srli_epi16(v, SHIFT); }
+		template <int SHIFT> static Vector shiftLeft(Vector v) { return _mm256_slli_epi16(v, SHIFT); }
+		static uint32_t moveMask(Vector v) { return (uint32_t)_mm256_movemask_epi8(v); }
+		static Vector addByteSums(Vector totals, Vector v) { return _mm256_add_epi64(totals, _mm256_sad_epu8(v, _mm256_setzero_si256())); }
+		static size_t getTotal(Vector totals)
+		{
+			uint64_t lanes[4];
+			_mm256_storeu_si256((__m256i*)lanes, totals);
+			return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+		}
+	};
+#elif defined(MAZE_SCAN_SSE2)
+	struct Isa
+	{
+		typedef __m128i Vector;
+		static const size_t WIDTH = 16;
+		static Vector load(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+		static void store(uint8_t* p, Vector v) { _mm_storeu_si128((__m128i*)p, v); }
+		static Vector zero() { return _mm_setzero_si128(); }
+		static Vector set(uint8_t value) { return _mm_set1_epi8((char)value); }
+		static Vector bitAnd(Vector a, Vector b) { return _mm_and_si128(a, b); }
+		static Vector bitOr(Vector a, Vector b) { return _mm_or_si128(a, b); }
+		static Vector andNot(Vector a, Vector b) { return _mm_andnot_si128(a, b); }
+		static Vector addBytes(Vector a, Vector b) { return _mm_add_epi8(a, b); }
+		static Vector equalBytes(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+		//There are no byte shifts, so shift 16-bit lanes; bits crossing into the other byte are masked off by every caller
+		template <int SHIFT> static Vector shiftRight(Vector v) { return _mm_srli_epi16(v, SHIFT); }
+		template <int SHIFT> static Vector shiftLeft(Vector v) { return _mm_slli_epi16(v, SHIFT); }
+		static uint32_t moveMask(Vector v) { return (uint32_t)_mm_movemask_epi8(v); }
+		static Vector addByteSums(Vector totals, Vector v) { return _mm_add_epi64(totals, _mm_sad_epu8(v, _mm_setzero_si128())); }
+		static size_t getTotal(Vector totals)
+		{
+			uint64_t lanes[2];
+			_mm_storeu_si128((__m128i*)lanes, totals);
+			return (size_t)(lanes[0] + lanes[1]);
+		}
+	};
+#endif
+
+#if defined(MAZE_SCAN_AVX2) || defined(MAZE_SCAN_SSE2)
+	unsigned int countTrailingZeros(uint32_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctz(bits);
+#endif
+	}
+
+	//Number of directions set in each byte's low four bits
+	Isa::Vector countDirections(Isa::Vector directions)
+	{
+		Isa::Vector pairs = Isa::addBytes(Isa::bitAnd(directions, Isa::set(0x05)), Isa::bitAnd(Isa::shiftRight<1>(directions), Isa::set(0x05)));
+		return Isa::addBytes(Isa::bitAnd(pairs, Isa::set(0x03)), Isa::bitAnd(Isa::shiftRight<2>(pairs), Isa::set(0x03)));
+	}
+
+	//Scans whole vectors of cells from x, stopping while the cell after the last one loaded is still in the row so
+	//the east neighbours can be loaded unaligned. Returns the first cell left unscanned
+	size_t scanCells(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX,
+		uint8_t wallCountMask, uint8_t* exits, uint8_t* walls, std::vector<size_t>* deadEnds, RowCounts& counts)
+	{
+		const Isa::Vector zero = Isa::zero();
+		const Isa::Vector lowBits = Isa::set(0x0F);
+		const Isa::Vector visited = Isa::set(CELL_VISITED);
+		const Isa::Vector pathN = Isa::set(CELL_PATH_N);
+		const Isa::Vector pathE = Isa::set(CELL_PATH_E);
+		const Isa::Vector pathS = Isa::set(CELL_PATH_S);
+		const Isa::Vector pathW = Isa::set(CELL_PATH_W);
+		const Isa::Vector countMask = Isa::set(wallCountMask);
+		Isa::Vector wallTotals = zero;
+		for (; x + Isa::WIDTH < sizeX; x += Isa::WIDTH)
+		{
+			Isa::Vector cell = Isa::load(row + x);
+			Isa::Vector left = Isa::load(row + x - 1);
+			Isa::Vector right = Isa::load(row + x + 1);
+			Isa::Vector above = rowAbove != NULL ? Isa::load(rowAbove + x) : zero;
+			Isa::Vector below = rowBelow != NULL ? Isa::load(rowBelow + x) : zero;
+
+			Isa::Vector cellExits = Isa::bitOr(Isa::bitOr(Isa::bitAnd(cell, lowBits), Isa::bitAnd(Isa::shiftRight<2>(above), pathN)),
+				Isa::bitOr(Isa::bitOr(Isa::bitAnd(Isa::shiftRight<2>(right), pathE), Isa::bitAnd(Isa::shiftLeft<2>(below), pathS)),
+					Isa::bitAnd(Isa::shiftLeft<2>(left), pathW)));
+			if (exits != NULL)
+			{
+				Isa::store(exits + x, cellExits);
+			}
+			if (walls != NULL)
+			{
+				Isa::Vector generated = Isa::bitOr(Isa::bitOr(Isa::bitAnd(Isa::equalBytes(Isa::bitAnd(cell, visited), visited), lowBits),
+					Isa::bitAnd(Isa::shiftRight<4>(above), pathN)), Isa::bitOr(Isa::bitOr(Isa::bitAnd(Isa::shiftRight<3>(right), pathE),
+						Isa::bitAnd(Isa::shiftRight<2>(below), pathS)), Isa::bitAnd(Isa::shiftRight<1>(left), pathW)));
+				Isa::Vector cellWalls = Isa::andNot(cellExits, generated);
+				Isa::store(walls + x, cellWalls);
+				wallTotals = Isa::addByteSums(wallTotals, countDirections(Isa::bitAnd(cellWalls, countMask)));
+			}
+			if (deadEnds != NULL)
+			{
+				uint32_t deadEndBits = Isa::moveMask(Isa::equalBytes(countDirections(cellExits), pathN));
+				while (deadEndBits != 0)
+				{
+					deadEnds->push_back(x + countTrailingZeros(deadEndBits));
+					deadEndBits &= deadEndBits - 1;
+					counts.numDeadEnds++;
+				}
+			}
+		}
+		counts.numWalls += Isa::getTotal(wallTotals);
+		return x;
+	}
+#endif
+
+	RowCounts scanRow(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX,
+		uint8_t* exits, uint8_t* walls, std::vector<size_t>* deadEnds)
+	{
+		RowCounts counts = { 0, 0 };
+		if (sizeX == 0)
+		{
+			return counts;
+		}
+		//Walls each cell owns when counting, see MazeScan::getRowWalls()
+		uint8_t wallCountMask = rowBelow != NULL ? CELL_PATH_N | CELL_PATH_W : CELL_PATH_N | CELL_PATH_S | CELL_PATH_W;
+		//The first cell has no west neighbour to load, so it is always scanned on its own
+		scanCell(rowAbove, row, rowBelow, 0, sizeX, wallCountMask, exits, walls, deadEnds, counts);
+		size_t x = 1;
+#if defined(MAZE_SCAN_AVX2) || defined(MAZE_SCAN_SSE2)
+		x = scanCells(rowAbove, row, rowBelow, x, sizeX, wallCountMask, exits, walls, deadEnds, counts);
+#endif
+		for (; x < sizeX; x++)
+		{
+			scanCell(rowAbove, row, rowBelow, x, sizeX, wallCountMask, exits, walls, deadEnds, counts);
+		}
+		return counts;
+	}
+}
+
+uint8_t MazeScan::getCellExits(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX)
+{
+	return cellExits(row[x], rowAbove != NULL ? rowAbove[x] : (uint8_t)CELL_NULL, x < sizeX - 1 ? row[x + 1] : (uint8_t)CELL_NULL,
+		rowBelow != NULL ? rowBelow[x] : (uint8_t)CELL_NULL, x > 0 ? row[x - 1] : (uint8_t)CELL_NULL);
+}
+
+uint8_t MazeScan::getCellWalls(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX)
+{
+	return cellWalls(row[x], rowAbove != NULL ? rowAbove[x] : (uint8_t)CELL_NULL, x < sizeX - 1 ? row[x + 1] : (uint8_t)CELL_NULL,
+		rowBelow != NULL ? rowBelow[x] : (uint8_t)CELL_NULL, x > 0 ? row[x - 1] : (uint8_t)CELL_NULL);
+}
+
+void MazeScan::getRowExits(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, uint8_t* exits)
+{
+	scanRow(rowAbove, row, rowBelow, sizeX, exits, NULL, NULL);
+}
+
+size_t MazeScan::getRowWalls(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, uint8_t* walls)
+{
+	return scanRow(rowAbove, row, rowBelow, sizeX, NULL, walls, NULL).numWalls;
+}
+
+size_t MazeScan::findRowDeadEnds(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, std::vector<size_t>& deadEnds)
+{
+	return scanRow(rowAbove, row, rowBelow, sizeX, NULL, NULL, &deadEnds).numDeadEnds;
+}
+
+const char* MazeScan::getInstructionSet()
+{
+#if defined(MAZE_SCAN_AVX2)
+	return "avx2";
+#elif defined(MAZE_SCAN_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef MAZE_SCAN_H
+#define MAZE_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Whole-row kernels over the maze's cell bytes, for finding dead ends and walls without looking at each
+//cell's four neighbours one at a time. Each takes the row being scanned and the rows either side of it,
+//with NULL for a row outside the maze. Rows are processed 32 cells at a time with AVX2 or 16 at a time
+//with SSE2, when the compiler targets them, and cell by cell otherwise
+class MazeScan
+{
+public:
+	//Exits of a single cell, counting paths recorded by its neighbours
+	static uint8_t getCellExits(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX);
+	//Walls of a single cell: the directions without an exit where either side has been generated
+	static uint8_t getCellWalls(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t x, size_t sizeX);
+
+	//Fills exits[x] for every cell in the row
+	static void getRowExits(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, uint8_t* exits);
+	//Fills walls[x] for every cell in the row and returns the number of walls the row owns. Each cell owns
+	//its north and west walls, the last cell its east wall too, and the last row (rowBelow == NULL) its
+	//south walls, so the counts of all rows add up to the number of distinct walls in the maze
+	static size_t getRowWalls(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, uint8_t* walls);
+	//Appends the x of every dead end in the row to deadEnds, and returns how many were found
+	static size_t findRowDeadEnds(const uint8_t* rowAbove, const uint8_t* row, const uint8_t* rowBelow, size_t sizeX, std::vector<size_t>& deadEnds);
+
+	//"avx2", "sse2" or "scalar", whichever the kernels were compiled for
+	static const char* getInstructionSet();
+};
+
+#endif
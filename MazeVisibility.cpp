@@ -0,0 +1,140 @@
+#include "MazeVisibility.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	//Positive when b is anticlockwise of a, turning from x towards y
+	float cross(glm::vec2 a, glm::vec2 b)
+	{
+		return a.x * b.y - a.y * b.x;
+	}
+
+	const uint8_t DIRECTIONS[4] = { CELL_PATH_N, CELL_PATH_E, CELL_PATH_S, CELL_PATH_W };
+	const uint8_t OPPOSITES[4] = { CELL_PATH_S, CELL_PATH_W, CELL_PATH_N, CELL_PATH_E };
+	const int OFFSETS_X[4] = { 0, 1, 0, -1 };
+	const int OFFSETS_Y[4] = { -1, 0, 1, 0 };
+	//The ends of the edge on each side of a cell, relative to its north west corner
+	const float EDGE_STARTS[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f } };
+	const float EDGE_ENDS[4][2] = { { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+}
+
+MazeVisibility::MazeVisibility(const CompactMaze& maze, float margin)
+	: maze(maze)
+{
+	MazeVisibility::margin = margin;
+	MazeVisibility::stamp = 0;
+	cellStamps.assign(MazeVisibility::maze.getSizeX() * MazeVisibility::maze.getSizeY(), 0);
+}
+
+void MazeVisibility::addVisibleCell(size_t x, size_t y)
+{
+	size_t cellIndex = y * maze.getSizeX() + x;
+	if (cellStamps[cellIndex] != stamp)
+	{
+		cellStamps[cellIndex] = stamp;
+		visibleCells.push_back(cellIndex);
+	}
+}
+
+//Searches outwards from a cell containing the camera, or within the margin of it. Every passage out of it is seen
+//whole, except those the camera is within the margin of, as the cell beyond them is searched from itself
+void MazeVisibility::searchFrom(size_t x, size_t y, glm::vec2 position)
+{
+	addVisibleCell(x, y);
+	uint8_t walls = maze.getWalls(x, y);
+	for (int i = 0; i < 4; i++)
+	{
+		if (walls & DIRECTIONS[i])
+		{
+			continue;
+		}
+		glm::vec2 first = glm::vec2((float)x + EDGE_STARTS[i][0], (float)y + EDGE_STARTS[i][1]) - position;
+		glm::vec2 last = glm::vec2((float)x + EDGE_ENDS[i][0], (float)y + EDGE_ENDS[i][1]) - position;
+		float distance = OFFSETS_X[i] != 0 ? std::fabs(first.x) : std::fabs(first.y);
+		if (distance < margin)
+		{
+			continue;
+		}
+		if (cross(first, last) < 0.0f)
+		{
+			std::swap(first, last);
+		}
+		Sightline sightline = { x + OFFSETS_X[i], y + OFFSETS_Y[i], OPPOSITES[i], first, last };
+		stack.push_back(sightline);
+	}
+
+	while (!stack.empty())
+	{
+		Sightline sightline = stack.back();
+		stack.pop_back();
+		addVisibleCell(sightline.x, sightline.y);
+		walls = maze.getWalls(sightline.x, sightline.y);
+		for (int i = 0; i < 4; i++)
+		{
+			if ((walls & DIRECTIONS[i]) || DIRECTIONS[i] == sightline.entered)
+			{
+				continue;
+			}
+			glm::vec2 first = glm::vec2((float)sightline.x + EDGE_STARTS[i][0], (float)sightline.y + EDGE_STARTS[i][1]) - position;
+			glm::vec2 last = glm::vec2((float)sightline.x + EDGE_ENDS[i][0], (float)sightline.y + EDGE_ENDS[i][1]) - position;
+			if (cross(first, last) < 0.0f)
+			{
+				std::swap(first, last);
+			}
+			//Narrow the range to the directions which also pass through this passage. Both ranges are less than a
+			//half turn, so they overlap only if the later start comes before the earlier end
+			if (cross(sightline.first, first) < 0.0f)
+			{
+				first = sightline.first;
+			}
+			if (cross(sightline.last, last) > 0.0f)
+			{
+				last = sightline.last;
+			}
+			if (cross(first, last) <= 0.0f)
+			{
+				continue;
+			}
+			Sightline next = { sightline.x + OFFSETS_X[i], sightline.y + OFFSETS_Y[i], OPPOSITES[i], first, last };
+			stack.push_back(next);
+		}
+	}
+}
+
+bool MazeVisibility::findVisibleCells(glm::vec2 position)
+{
+	visibleCells.clear();
+	size_t sizeX = maze.getSizeX();
+	size_t sizeY = maze.getSizeY();
+	if (!(position.x >= 0.0f && position.y >= 0.0f && position.x < (float)sizeX && position.y < (float)sizeY))
+	{
+		return false;
+	}
+	stamp++;
+	if (stamp == 0)
+	{
+		std::fill(cellStamps.begin(), cellStamps.end(), 0);
+		stamp = 1;
+	}
+	//Search from the camera's cell, and from any neighbour whose walls are close enough that it may see past them
+	size_t cellX = (size_t)position.x;
+	size_t cellY = (size_t)position.y;
+	for (size_t y = cellY > 0 ? cellY - 1 : 0; y <= std::min(cellY + 1, sizeY - 1); y++)
+	{
+		for (size_t x = cellX > 0 ? cellX - 1 : 0; x <= std::min(cellX + 1, sizeX - 1); x++)
+		{
+			if (position.x >= (float)x - margin && position.x <= (float)x + 1.0f + margin &&
+				position.y >= (float)y - margin && position.y <= (float)y + 1.0f + margin)
+			{
+				searchFrom(x, y, position);
+			}
+		}
+	}
+	return true;
+}
+
+const std::vector<size_t>& MazeVisibility::getVisibleCells()
+{
+	return visibleCells;
+}
@@ -0,0 +1,45 @@
+#ifndef MAZE_VISIBILITY_H
+#define MAZE_VISIBILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+#include "CompactMaze.h"
+
+//Finds the cells of a finished maze which can be seen from a point inside it, for a camera below the tops of the
+//walls. Sight only leaves a cell through a passage, so cells are visited outwards from the camera's cell, and
+//each keeps the range of directions from the camera which pass through every passage on the way to it; a passage
+//outside that range ends the search along it. A perfect maze has a single route between any two cells, so every
+//cell is reached at most once from each starting cell, and the cost depends only on how many cells are in sight
+class MazeVisibility
+{
+private:
+	struct Sightline
+	{
+		size_t x, y;
+		uint8_t entered;	//The side the cell was entered from, which is not searched again
+		glm::vec2 first, last;	//The range of directions, from first anticlockwise to last
+	};
+
+	CompactMaze maze;
+	float margin;
+	std::vector<Sightline> stack;
+	std::vector<uint32_t> cellStamps;
+	uint32_t stamp;
+	std::vector<size_t> visibleCells;
+
+	void addVisibleCell(size_t x, size_t y);
+	void searchFrom(size_t x, size_t y, glm::vec2 position);
+public:
+	//margin is how close, in cells, the camera can get to a wall before it may see through it, from the wall's
+	//thickness and the camera's near plane. Cells closer than this are searched from as well as its own
+	MazeVisibility(const CompactMaze& maze, float margin);
+
+	//Finds the cells visible from position, measured in cells from the north west corner of the maze, as indices
+	//y * sizeX + x. Returns false, finding nothing, if the position is not inside the maze
+	bool findVisibleCells(glm::vec2 position);
+	const std::vector<size_t>& getVisibleCells();
+};
+
+#endif
@@ -33,19 +33,24 @@ Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std:
     this->vertices = vertices;
     this->indices = indices;
     this->textures = textures;
+    //0 is never a program, so the uniforms are looked up on the first draw
+    this->uniformProgramId = 0;
 
     setupMesh();
 }
 
-void Mesh::Draw(Shader& shader)
+//Looks up the sampler for each texture, named by its type and number, and the instanced flag, so that
+//drawing sets them by location without building or hashing any names
+void Mesh::resolveUniforms(Shader& shader)
 {
+    uniformProgramId = shader.getProgramId();
+    int maxTextureUnits = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
     unsigned int numDiffuse = 1;
     unsigned int numSpecular = 1;
-    int *maxTextureUnits =  new int[1];
-    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, maxTextureUnits);
-    for (size_t i = 0; i < textures.size() && i < *maxTextureUnits; i++)
+    textureUniforms.clear();
+    for (size_t i = 0; i < textures.size() && i < (size_t)maxTextureUnits; i++)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
         std::string number;
         std::string name = textures[i].type;
         if (name == "texture_diffuse")
@@ -56,14 +61,63 @@ void Mesh::Draw(Shader& shader)
         {
             number = std::to_string(numSpecular++);
         }
-        shader.setFloat(("material." + name + number).c_str(), i);
+        textureUniforms.push_back(shader.getUniform<int>("material." + name + number));
+    }
+    instancedUniform = shader.getUniform<bool>("instanced");
+}
+
+void Mesh::bindTextures(Shader& shader)
+{
+    if (shader.getProgramId() != uniformProgramId)
+    {
+        resolveUniforms(shader);
+    }
+    for (size_t i = 0; i < textureUniforms.size(); i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        textureUniforms[i].set((int)i);
         glBindTexture(GL_TEXTURE_2D, textures[i].id);
     }
     glActiveTexture(GL_TEXTURE0);
-    delete maxTextureUnits;
+}
+
+void Mesh::Draw(Shader& shader)
+{
+    bindTextures(shader);
 
     //Draw mesh
+    instancedUniform.set(false);
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
+
+//Attaches a buffer of glm::mat4 model matrices to this mesh's VAO, advancing once per instance
+void Mesh::setInstanceBuffer(unsigned int instanceVBO)
+{
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    //A mat4 attribute occupies four consecutive vec4 locations
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(3 + i, 1);
+    }
+    glBindVertexArray(0);
+}
+
+void Mesh::DrawInstanced(Shader& shader, size_t numInstances, size_t baseInstance)
+{
+    if (numInstances == 0)
+    {
+        return;
+    }
+    bindTextures(shader);
+
+    //Draw all instances in a single call, starting from baseInstance in the instance buffer
+    instancedUniform.set(true);
+    glBindVertexArray(VAO);
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, numInstances, baseInstance);
+    glBindVertexArray(0);
+}
@@ -20,8 +20,14 @@ class Mesh
 {
 private:
 	unsigned int VAO, VBO, EBO;
+	//Uniforms of the shader last drawn with, one per texture, looked up again only when the shader changes
+	GLuint uniformProgramId;
+	std::vector<Uniform<int>> textureUniforms;
+	Uniform<bool> instancedUniform;
 
 	void setupMesh();
+	void resolveUniforms(Shader& shader);
+	void bindTextures(Shader& shader);
 public:
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
@@ -29,5 +35,8 @@ public:
 
 	Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
 	void Draw(Shader& shader);
+	//Instanced drawing, model matrices are read from the attached instance buffer
+	void setInstanceBuffer(unsigned int instanceVBO);
+	void DrawInstanced(Shader& shader, size_t numInstances, size_t baseInstance = 0);
 };
 
@@ -185,3 +185,34 @@ void Model::Draw(Shader& shader)
 		meshes[i].Draw(shader);
 	}
 }
+
+void Model::setInstanceBuffer(unsigned int instanceVBO)
+{
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		meshes[i].setInstanceBuffer(instanceVBO);
+	}
+}
+
+void Model::DrawInstanced(Shader& shader, size_t numInstances, size_t baseInstance)
+{
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		meshes[i].DrawInstanced(shader, numInstances, baseInstance);
+	}
+}
+
+unsigned int Model::getTextureId(std::string type)
+{
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		for (size_t j = 0; j < meshes[i].textures.size(); j++)
+		{
+			if (meshes[i].textures[j].type == type)
+			{
+				return meshes[i].textures[j].id;
+			}
+		}
+	}
+	return 0;
+}
\ No newline at end of file
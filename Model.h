@@ -20,5 +20,9 @@ private:
 public:
 	Model(std::string);
 	void Draw(Shader& shader);
+	void setInstanceBuffer(unsigned int instanceVBO);
+	void DrawInstanced(Shader& shader, size_t numInstances, size_t baseInstance = 0);
+	//Id of the first texture of this type in any of the meshes, or 0 if there is none
+	unsigned int getTextureId(std::string type);
 };
 
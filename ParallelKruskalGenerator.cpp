@@ -0,0 +1,132 @@
+#include "ParallelKruskalGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "ConcurrentDisjointSet.h"
+#include "RandomPermutation.h"
+#include "TiledGenerator.h"
+
+const size_t ParallelKruskalGenerator::CELLS_PER_BAND;
+const size_t ParallelKruskalGenerator::MIN_BANDS;
+
+ParallelKruskalGenerator::ParallelKruskalGenerator(unsigned int numThreads)
+{
+	ParallelKruskalGenerator::numThreads = numThreads > 0 ? numThreads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+std::string ParallelKruskalGenerator::getName()
+{
+	return "parallelkruskal";
+}
+
+void ParallelKruskalGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	const size_t numCells = sizeX * sizeY;
+	if (numCells > 0xFFFFFFFFULL)
+	{
+		//The disjoint set uses 32-bit elements, larger mazes are still generated in parallel, one tile at a time
+		std::unique_ptr<MazeGenerator> tiled(new TiledGenerator("kruskal", numThreads));
+		tiled->carve(maze, random);
+		return;
+	}
+
+	//Like the tiles of TiledGenerator, the bands depend on the maze size alone, so the thread count
+	//does not change the maze
+	size_t bandRows = std::max((size_t)1, std::min(CELLS_PER_BAND / sizeX, sizeY / MIN_BANDS));
+	size_t numBands = (sizeY + bandRows - 1) / bandRows;
+	std::vector<uint64_t> bandSeeds(numBands);
+	for (size_t i = 0; i < numBands; i++)
+	{
+		bandSeeds[i] = random.next();
+	}
+	uint64_t seamSeed = random.next();
+
+	//Each cell records its own east and south passages, and every wall belongs to the band of the cell
+	//above or left of it, so each cell is only ever written by the one worker which owns its band.
+	//The event log only accepts one writer, so when changes are tracked the workers fill a scratch copy
+	std::vector<uint8_t> scratch;
+	uint8_t* cells = maze->getMaze();
+	if (maze->isTrackingChanges())
+	{
+		scratch.assign(maze->getMazeLength(), CELL_NULL);
+		cells = scratch.data();
+	}
+
+	ConcurrentDisjointSet sets(numCells);
+	std::atomic<size_t> nextBand(0);
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < std::min((size_t)numThreads, numBands); i++)
+	{
+		workers.push_back(std::thread([&]()
+		{
+			for (size_t band = nextBand++; band < numBands; band = nextBand++)
+			{
+				size_t startY = band * bandRows;
+				size_t endY = std::min(startY + bandRows, sizeY);
+				for (size_t y = startY; y < endY; y++)
+				{
+					for (size_t x = 0; x < sizeX; x++)
+					{
+						cells[maze->getCellIndex(x, y)] = CELL_VISITED;
+					}
+				}
+				//Walls are numbered (cell in band << 1) | 1 for the east wall, or << 1 alone for the south wall,
+				//and visited in a shuffled order without storing the shuffled list
+				size_t bandCells = (endY - startY) * sizeX;
+				RandomPermutation walls(2 * bandCells, bandSeeds[band]);
+				for (size_t i = 0; i < 2 * bandCells; i++)
+				{
+					size_t wall = walls.get(i);
+					bool east = (wall & 1) != 0;
+					size_t x = (wall >> 1) % sizeX;
+					size_t y = startY + (wall >> 1) / sizeX;
+					if (east ? x == sizeX - 1 : y == endY - 1)
+					{
+						continue;	//Outer wall of the maze, or a seam with the next band, which is joined afterwards
+					}
+					uint32_t cellNumber = (uint32_t)(y * sizeX + x);
+					if (sets.join(cellNumber, east ? cellNumber + 1 : cellNumber + (uint32_t)sizeX))
+					{
+						cells[maze->getCellIndex(x, y)] |= east ? CELL_PATH_E : CELL_PATH_S;
+					}
+				}
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	//Workers only join cells of their own band, so which of them succeed does not depend on timing. The
+	//south walls of each band's last row would join two bands at once, so they are visited here, in order
+	size_t numSeamWalls = (numBands - 1) * sizeX;
+	RandomPermutation seamWalls(numSeamWalls, seamSeed);
+	for (size_t i = 0; i < numSeamWalls; i++)
+	{
+		size_t wall = seamWalls.get(i);
+		size_t x = wall % sizeX;
+		size_t y = (wall / sizeX + 1) * bandRows - 1;
+		uint32_t cellNumber = (uint32_t)(y * sizeX + x);
+		if (sets.join(cellNumber, cellNumber + (uint32_t)sizeX))
+		{
+			cells[maze->getCellIndex(x, y)] |= CELL_PATH_S;
+		}
+	}
+
+	if (maze->isTrackingChanges())
+	{
+		for (size_t y = 0; y < sizeY; y++)
+		{
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				maze->addCellLocation(std::pair<size_t, size_t>(x, y));
+				maze->setCell(x, y, cells[maze->getCellIndex(x, y)]);
+				step(maze, x, y);
+			}
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef PARALLEL_KRUSKAL_GENERATOR_H
+#define PARALLEL_KRUSKAL_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Randomised Kruskal with its wall processing spread across threads. The walls are split into bands of rows,
+//each band's inner walls are visited in a random order on one worker, and every worker joins cells through one
+//shared ConcurrentDisjointSet. The walls between bands are visited afterwards in a seeded order on one thread,
+//so the maze depends only on the seed, whatever the thread count
+class ParallelKruskalGenerator : public MazeGenerator
+{
+private:
+	//At most this many cells per band, so each band's part of the disjoint set stays in cache
+	static const size_t CELLS_PER_BAND = 1 << 20;
+	//Bands are made smaller until there are at least this many to share between threads
+	static const size_t MIN_BANDS = 64;
+
+	unsigned int numThreads;
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	//A thread count of 0 uses one thread per hardware thread
+	ParallelKruskalGenerator(unsigned int numThreads = 0);
+
+	std::string getName();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "PrimGenerator.h"
+#include "VisitedBitboard.h"
+
+std::string PrimGenerator::getName()
+{
+	return "prim";
+}
+
+void PrimGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	//Cells in the maze so far, and cells next to it which are waiting to be joined. Both have a
+	//border which reads as set, so neither mask below can point outside the maze
+	VisitedBitboard visited(sizeX, sizeY);
+	VisitedBitboard inFrontier(sizeX, sizeY);
+	//Frontier cells, numbered row by row
+	std::vector<size_t> frontier;
+
+	size_t currentX = random.nextBelow(sizeX);
+	size_t currentY = random.nextBelow(sizeY);
+	maze->addCellLocation(std::pair<size_t, size_t>(currentX, currentY));
+	maze->setCell(currentX, currentY, CELL_VISITED);
+	visited.setVisited(currentX, currentY);
+	while (true)
+	{
+		//Add the new cell's unvisited neighbours to the frontier
+		uint8_t newFrontier = visited.getUnvisitedNeighbours(currentX, currentY) & inFrontier.getUnvisitedNeighbours(currentX, currentY);
+		for (uint8_t direction = 0; direction < 4; direction++)
+		{
+			if (newFrontier & (1 << direction))
+			{
+				size_t nextX = currentX + DIRECTION_X[direction];
+				size_t nextY = currentY + DIRECTION_Y[direction];
+				inFrontier.setVisited(nextX, nextY);
+				frontier.push_back(nextY * sizeX + nextX);
+			}
+		}
+		if (frontier.empty())
+		{
+			break;
+		}
+
+		//Take a random frontier cell, and join it to a random neighbour already in the maze
+		size_t chosen = random.nextBelow(frontier.size());
+		size_t cellNumber = frontier[chosen];
+		frontier[chosen] = frontier.back();
+		frontier.pop_back();
+		currentX = cellNumber % sizeX;
+		currentY = cellNumber / sizeX;
+		uint8_t routes = ~visited.getUnvisitedNeighbours(currentX, currentY) & getNeighbourMask(currentX, currentY, sizeX, sizeY);
+		carvePassage(maze, currentX, currentY, chooseRoute(routes, random));
+		visited.setVisited(currentX, currentY);
+		step(maze, currentX, currentY);
+	}
+}
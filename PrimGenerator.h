@@ -0,0 +1,16 @@
+#ifndef PRIM_GENERATOR_H
+#define PRIM_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Randomised Prim: grows the maze from a single cell, joining a random cell from its frontier each step.
+//Gives short, branching corridors radiating from the start
+class PrimGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
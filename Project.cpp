@@ -14,18 +14,24 @@
 
 #include <iostream>
 #include <vector>
-#include <stack>
 #include <ctime>
 #include <chrono>
 #include <thread>
-#include <mutex>
+#include <memory>
 
 #pragma warning(pop)
 
 #include "Project.h"
 #include "Shader.h"
 #include "Maze.h"
+#include "CompactMaze.h"
 #include "Model.h"
+#include "InstanceBuffer.h"
+#include "FrameUniforms.h"
+#include "MazeMesh.h"
+#include "MazeVisibility.h"
+#include "MazeGenerator.h"
+#include "MazeScan.h"
 
 //Settings
 const unsigned int SCR_WIDTH = 1280;
@@ -58,24 +64,15 @@ const int tickRate = 20;
 float deltaTime = 0.0f;
 float lastFrameTime = 0.0f;
 
-//For sharing access to maze arrays
-std::mutex mazeArrayMutex;
-std::atomic<bool> generationComplete = false;
+//Copied from the maze each tick, set once the maze, start and win cells are final
+bool generationComplete = false;
 
 //For drawing floor and determining positions within cells
 const float cellSize = 10.0f;
 const float scaleFactor = 0.05f;
-
-//Constants to define maze paths
-enum
-{
-	CELL_NULL = 0x00,
-	CELL_PATH_N = 0x01,	//Constants numbered to have 1 bit each
-	CELL_PATH_E = 0x02,
-	CELL_PATH_S = 0x04,
-	CELL_PATH_W = 0x08,
-	CELL_VISITED = 0x10
-};
+//Size of wall.obj once scaled into the world, so baked walls match the instanced ones
+const float wallHeight = 2.25f * 0.25f;
+const float wallThickness = 0.2f * 0.25f;
 
 std::pair<float, float> cellLocationToWorldSpace(int x, int y)
 {
@@ -84,187 +81,125 @@ std::pair<float, float> cellLocationToWorldSpace(int x, int y)
 	return std::pair<float, float>(worldX, worldZ);
 }
 
+//Position in cells from the north west corner of the maze, the inverse of cellLocationToWorldSpace()
+std::pair<float, float> worldSpaceToCellSpace(float x, float z)
+{
+	float cellWidth = cellSize * scaleFactor;
+	return std::pair<float, float>(x / cellWidth + camSizeX / 2.0f, z / cellWidth + camSizeY / 2.0f);
+}
+
+//Rounds down, so positions outside the maze give cells outside it
 std::pair<int, int> worldSpaceToCellLocation(float x, float z)
 {
-	float camRangeX = camSizeX / 2;
-	float camRangeZ = camSizeY / 2;
-	float xMapped = (x + camRangeX / 2) * 2;
-	float zMapped = (z + camRangeZ / 2) * 2;
-	int cellX = (int)xMapped;
-	int cellY = (int)zMapped;
-	return std::pair<int, int>(cellX, cellY);
+	std::pair<float, float> cellSpace = worldSpaceToCellSpace(x, z);
+	return std::pair<int, int>((int)floor(cellSpace.first), (int)floor(cellSpace.second));
+}
+
+//Walls are keyed by the edge they sit on: horizontal edges (north of row y, 0 <= y <= sizeY) come first,
+//followed by vertical edges (west of column x, 0 <= x <= sizeX). Neighbouring cells share a wall.
+size_t numWallKeys(size_t sizeX, size_t sizeY)
+{
+	return sizeX * (sizeY + 1) + (sizeX + 1) * sizeY;
 }
 
-void initMaze(Maze *maze, int waitTimeMs)
+size_t wallKey(size_t x, size_t y, uint8_t direction, size_t sizeX, size_t sizeY)
 {
-	mazeArrayMutex.lock();
-	size_t sizeX = maze->getSizeX();
-	size_t sizeY = maze->getSizeY();
-	mazeArrayMutex.unlock();
-	int sizeXoffset = static_cast<int>(sizeX);
-	int sizeYoffset = static_cast<int>(sizeY);
-
-	//Cast values to platform max as they will be used for determining memory addresses
-	if (sizeX == 0 || sizeY == 0)
+	size_t key;
+	switch (direction)
 	{
-		return;	//Do not generate a maze as invalid input was used
+	case CELL_PATH_N:
+		key = y * sizeX + x;
+		break;
+	case CELL_PATH_S:
+		key = (y + 1) * sizeX + x;
+		break;
+	case CELL_PATH_W:
+		key = sizeX * (sizeY + 1) + y * (sizeX + 1) + x;
+		break;
+	default:
+		key = sizeX * (sizeY + 1) + y * (sizeX + 1) + x + 1;
+		break;
 	}
-	const size_t xSize = static_cast<size_t>(sizeX);
-	const size_t ySize = static_cast<size_t>(sizeY);
-
-	//Allocate array for chosen route
-	uint8_t* chosen;
-	chosen = new uint8_t[xSize * ySize];
-	memset(chosen, 0x00, xSize * ySize);
-
-	//Route generation
-	std::stack<std::pair<unsigned int, unsigned int>> visitedLog;
-	//Choose a random start point
-	srand(time(0));
-	unsigned int randX = rand() % sizeX;
-	unsigned int randY = rand() % sizeY;
-	//Push it to the stack
-	visitedLog.push(std::pair<unsigned int, unsigned int>(randX, randY));
-	unsigned int numVisited = 1;
-	unsigned int currentX;
-	unsigned int currentY;
-
-	bool stop = false;
-	while (!stop)
+	return key;
+}
+
+glm::mat4 floorModelMatrix(size_t x, size_t y)
+{
+	std::pair<float, float> worldSpace = cellLocationToWorldSpace(x, y);
+
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+	modelMatrix = glm::translate(modelMatrix, glm::vec3(worldSpace.first, 0.0f, worldSpace.second));
+	modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
+	return modelMatrix;
+}
+
+glm::mat4 wallModelMatrix(size_t x, size_t y, uint8_t direction)
+{
+	std::pair<float, float> worldSpace = cellLocationToWorldSpace(x, y);
+	float offsetX = worldSpace.first;
+	float offsetY = worldSpace.second;
+	float halfCell = cellSize * scaleFactor / 2;
+
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+	switch (direction)
 	{
-		currentX = visitedLog.top().first;
-		currentY = visitedLog.top().second;
-		uint8_t* thisCell = chosen + ((currentY * xSize) + currentX);
-		mazeArrayMutex.lock();
-		maze->setCurrentLocation(currentX, currentY);
-		//Do not add this cell to the list if its already been visited
-		if (!(*thisCell & CELL_VISITED))
-		{
-			maze->addCellLocation(std::pair<size_t, size_t>(currentX, currentY));
-			//Mark this cell as visited
-			*thisCell |= CELL_VISITED;
-			maze->setMaze(chosen, numVisited * sizeof(uint8_t));
-		}
-		mazeArrayMutex.unlock();
-		//Try to find an unvisited neighbour
-		std::vector<uint8_t> possibleRoutes;
-		//Check N, E, S & W
-		uint8_t* checkCell;
-		if (currentY > 0)
-		{
-			//Check north
-			checkCell = thisCell - xSize;
-			if (!(*checkCell & CELL_VISITED))
-			{
-				possibleRoutes.push_back(CELL_PATH_N);
-			}
-		}
-		if (currentX < sizeX - 1)
-		{
-			//Check east
-			checkCell = thisCell + 1;
-			if (!(*checkCell & CELL_VISITED))
-			{
-				possibleRoutes.push_back(CELL_PATH_E);
-			}
-		}
-		if (currentY < sizeY - 1)
-		{
-			//Check south
-			checkCell = thisCell + xSize;
-			if (!(*checkCell & CELL_VISITED))
-			{
-				possibleRoutes.push_back(CELL_PATH_S);
-			}
-		}
-		if (currentX > 0)
-		{
-			//Check west
-			checkCell = thisCell - 1;
-			if (!(*checkCell & CELL_VISITED))
-			{
-				possibleRoutes.push_back(CELL_PATH_W);
-			}
-		}
-		if (possibleRoutes.size() == 0)
-		{
-			if (numVisited == sizeX * sizeY)
-			{
-				//All cells have been set
-				stop = true;
-			}
-			else
-			{
-				//Backtrack
-				visitedLog.pop();
-			}
-		}
-		else
-		{
-			//There is a viable cell
-			int chosenRoute = rand() % possibleRoutes.size();
-			int newX, newY;
-			std::pair<GLfloat*, GLuint*> newPointers;
-			//Set path and push new cell onto stack
-			*thisCell |= possibleRoutes[chosenRoute];
-			switch (possibleRoutes[chosenRoute])
-			{
-			case CELL_PATH_N:
-				newX = currentX;
-				newY = currentY - 1;
-				break;
-			case CELL_PATH_E:
-				newX = currentX + 1;
-				newY = currentY;
-				break;
-			case CELL_PATH_S:
-				newX = currentX;
-				newY = currentY + 1;
-				break;
-			case CELL_PATH_W:
-				newX = currentX - 1;
-				newY = currentY;
-				break;
-			}
-			visitedLog.push(std::pair<unsigned int, unsigned int>(newX, newY));
-			numVisited++;
-			std::this_thread::sleep_for(std::chrono::milliseconds(waitTimeMs));
-		}
+	case CELL_PATH_N:
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 0.0f, offsetY - halfCell));
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		break;
+	case CELL_PATH_E:
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX + halfCell, 0.0f, offsetY));
+		break;
+	case CELL_PATH_S:
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 0.0f, offsetY + halfCell));
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		break;
+	case CELL_PATH_W:
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX - halfCell, 0.0f, offsetY));
+		break;
 	}
-	//Choose a start and end location
-	uint8_t* checkCell = chosen;
-	std::vector<std::pair<int, int>> potentialCells;
-	for (int y = 0; y < sizeY; y++)
+	modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
+	return modelMatrix;
+}
+
+//Adds or removes the wall on one side of a cell
+void setWallInstance(size_t x, size_t y, uint8_t direction, bool wall, size_t sizeX, size_t sizeY, InstanceBuffer& wallInstances)
+{
+	size_t key = wallKey(x, y, direction, sizeX, sizeY);
+	if (wall)
 	{
-		for (int x = 0; x < sizeX; x++)
+		if (!wallInstances.contains(key))
 		{
-			if (*checkCell == 0x10)
-			{
-				potentialCells.push_back(std::pair<int, int>(x, y));
-			}
-			checkCell++;
+			wallInstances.set(key, wallModelMatrix(x, y, direction));
 		}
 	}
-	if (potentialCells.size() > 2)
+	else
 	{
-		int chosenCell = rand() % potentialCells.size();
-		maze->setStartCell(potentialCells[chosenCell].first, potentialCells[chosenCell].second);
-		potentialCells.erase(potentialCells.begin() + chosenCell);
-		chosenCell = rand() % potentialCells.size();
-		maze->setWinCell(potentialCells[chosenCell].first, potentialCells[chosenCell].second);
+		wallInstances.remove(key);
 	}
-	else if (potentialCells.size() == 2)
+}
+
+//Sets the floor and the four walls of a cell from its walls as found by MazeScan
+void setCellInstances(size_t x, size_t y, uint8_t cell, uint8_t walls, size_t sizeX, size_t sizeY, InstanceBuffer& floorInstances, InstanceBuffer& wallInstances)
+{
+	if ((cell & CELL_VISITED) && !floorInstances.contains(y * sizeX + x))
 	{
-		maze->setStartCell(potentialCells[0].first, potentialCells[0].second);
-		maze->setWinCell(potentialCells[1].first, potentialCells[1].second);
+		floorInstances.set(y * sizeX + x, floorModelMatrix(x, y));
 	}
-	else
+
+	const uint8_t directions[4] = { CELL_PATH_N, CELL_PATH_E, CELL_PATH_S, CELL_PATH_W };
+	for (int i = 0; i < 4; i++)
 	{
-		maze->setStartCell(0, 0);
-		maze->setWinCell(sizeX - 1, sizeY - 1);
+		setWallInstance(x, y, directions[i], (walls & directions[i]) != 0, sizeX, sizeY, wallInstances);
 	}
-	generationComplete = true;
-	return;
+}
+
+//Re-evaluates the floor and the four walls of a cell after it has changed
+void updateCellInstances(size_t x, size_t y, uint8_t* mazeData, size_t sizeX, size_t sizeY, InstanceBuffer& floorInstances, InstanceBuffer& wallInstances)
+{
+	const uint8_t* row = mazeData + y * sizeX;
+	uint8_t walls = MazeScan::getCellWalls(y > 0 ? row - sizeX : NULL, row, y < sizeY - 1 ? row + sizeX : NULL, x, sizeX);
+	setCellInstances(x, y, row[x], walls, sizeX, sizeY, floorInstances, wallInstances);
 }
 
 //Input processing
@@ -392,6 +327,38 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 
 int main(int argc, char** argv)
 {
+	//Optional arguments: -seed <n> reproduces a previously generated maze, -algorithm <name> picks the generator,
+	//-farthest places the start and win cells at the ends of the longest route
+	uint64_t seed = (uint64_t)time(0);
+	std::string algorithm = "backtracker";
+	bool farthest = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "-seed" && i + 1 < argc)
+		{
+			seed = std::stoull(argv[++i]);
+		}
+		else if (argument == "-algorithm" && i + 1 < argc)
+		{
+			algorithm = argv[++i];
+		}
+		else if (argument == "-farthest")
+		{
+			farthest = true;
+		}
+	}
+	std::unique_ptr<MazeGenerator> generator(MazeGenerator::create(algorithm));
+	if (!generator)
+	{
+		std::cout << "Unknown algorithm " << algorithm << ", using backtracker" << std::endl;
+		generator.reset(MazeGenerator::create("backtracker"));
+	}
+	if (farthest)
+	{
+		generator->setPlacement(MazeGenerator::PLACE_FARTHEST_PAIR);
+	}
+
 	std::cout << "Enter desired maze size X (4 =< x =< 128): ";
 	int inputX, inputY;
 	std::cin >> inputX;
@@ -457,15 +424,22 @@ int main(int argc, char** argv)
 	//Compile shaders
 	Shader surfaceShader = Shader("media/SurfaceShader.vert", "media/SurfaceShader.frag");
 	surfaceShader.use();
-	
+	//Uniforms set every draw, located once instead of by name on every call
+	Uniform<glm::mat4> modelMatrixUniform = surfaceShader.getUniform<glm::mat4>("modelMatrix");
+
+	//Camera and lighting, uploaded once a frame and shared by every shader
+	FrameUniforms frameUniforms;
+	CameraUniforms& camera = frameUniforms.getCamera();
+	LightingUniforms& lighting = frameUniforms.getLighting();
+
 	//Lighting
 	//Directional light
-	surfaceShader.setVec3fv("directionalLight.direction", glm::vec3(-0.3f, -1.0f, -0.3f));
-	surfaceShader.setVec3fv("directionalLight.ambient", glm::vec3(0.05f, 0.05f, 0.05f));
-	surfaceShader.setVec3fv("directionalLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
-	surfaceShader.setVec3fv("directionalLight.specular", glm::vec3(0.5f, 0.5f, 0.5f));
+	lighting.directionalLight.direction = glm::vec3(-0.3f, -1.0f, -0.3f);
+	lighting.directionalLight.ambient = glm::vec3(0.05f, 0.05f, 0.05f);
+	lighting.directionalLight.diffuse = glm::vec3(0.5f, 0.5f, 0.5f);
+	lighting.directionalLight.specular = glm::vec3(0.5f, 0.5f, 0.5f);
 
-	surfaceShader.setInt("numPointLights", 0);
+	lighting.numPointLights = 0;
 
 	surfaceShader.setFloat("material.shininess", 16.0f);
 
@@ -475,11 +449,12 @@ int main(int argc, char** argv)
 	projectionMatrix = glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH / SCR_HEIGHT, 0.01f, 1000.0f);
 
 	//Build maze
-	Maze maze = Maze(sizeX, sizeY);
-	int generateMinTimeSecs = 5;
-	int generateWaitMs = std::max((int)(1000 / (float)((sizeX * sizeY) / generateMinTimeSecs)), 1);
-	//Start generation on seperate thread
-	std::thread th1(initMaze, &maze, generateWaitMs);
+	Maze maze(sizeX, sizeY);
+	//Start generation on seperate thread. It runs at full speed, and the render loop replays the
+	//maze's event log so that the animation lasts about replayTimeSecs
+	int replayTimeSecs = 5;
+	std::cout << "Generating maze with " << generator->getName() << " and seed " << seed << std::endl;
+	std::thread th1(&MazeGenerator::generate, generator.get(), &maze, seed);
 
 	//Load models for walls and floor
 	stbi_set_flip_vertically_on_load(true);
@@ -489,13 +464,27 @@ int main(int argc, char** argv)
 	Model startCube = Model("media/models/startcube.obj");
 	Model winCube = Model("media/models/wincube.obj");
 
+	//Per-instance model matrices, so every floor and every wall is drawn in one call each
+	InstanceBuffer floorInstances(sizeX * sizeY);
+	InstanceBuffer wallInstances(numWallKeys(sizeX, sizeY));
+	floor.setInstanceBuffer(floorInstances.getBufferId());
+	wall.setInstanceBuffer(wallInstances.getBufferId());
+	//The finished maze, built once the replay is over, and what can be seen of it from inside
+	std::unique_ptr<MazeMesh> mazeMesh;
+	std::unique_ptr<MazeVisibility> mazeVisibility;
+
 	//For storing maze data when it is polled from class
 	uint8_t *mazeData;
 	size_t mazeSizeX = maze.getSizeX();
 	size_t mazeSizeY = maze.getSizeY();
 	mazeData = new uint8_t[mazeSizeX * mazeSizeY];
 	memset(mazeData, 0x00, mazeSizeX * mazeSizeY);
-	std::vector<std::pair<size_t, size_t>> cellLocations;
+	//Changes read from the maze's event log since the last tick
+	std::vector<MazeChange> mazeChanges;
+	uint64_t mazeSequence = 0;
+	size_t replayChangesPerTick = 0;
+	bool resyncMaze = false;
+	std::vector<uint8_t> rowWalls(mazeSizeX);
 
 	float startTime = glfwGetTime();
 	float waitTime = 1.0f / (float)tickRate;
@@ -530,12 +519,11 @@ int main(int argc, char** argv)
 
 		//Render floor
 		surfaceShader.use();
-		//Update view position for lighting
-		surfaceShader.setVec3fv("viewPosition", cameraPosition);
-
-		//Send transformation matrices to shader via uniforms
-		surfaceShader.setMat4fv("viewMatrix", viewMatrix);
-		surfaceShader.setMat4fv("projectionMatrix", projectionMatrix);
+		//Send the view position for lighting and the transformation matrices to every shader
+		camera.viewPosition = cameraPosition;
+		camera.viewMatrix = viewMatrix;
+		camera.projectionMatrix = projectionMatrix;
+		frameUniforms.beginFrame();
 
 		//Track time to determine when to poll maze
 		float currentTime = glfwGetTime();
@@ -545,127 +533,101 @@ int main(int argc, char** argv)
 		//Update the game state at tick rate
 		if (currentTime >= startTime + waitTime)
 		{
-			if (mazeArrayMutex.try_lock())
-			{
-				memcpy(mazeData, maze.getMaze(), maze.getMazeLength());
-				cellLocations = maze.getCellLocations();
-				mazeArrayMutex.unlock();
-
-				startTime = currentTime;
-			}
-		}
-		//Iterate through all cells and draw required walls
-		for (std::vector<std::pair<size_t, size_t>>::iterator it = cellLocations.begin(); it != cellLocations.end(); ++it)
-		{
-			std::pair<float, float> worldSpace = cellLocationToWorldSpace(it->first, it->second);
-			float offsetX = worldSpace.first;
-			float offsetY = worldSpace.second;
-
-			modelMatrix = glm::mat4(1.0f);
-			
-			modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 0.0f, offsetY));
-			modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
-			
-			surfaceShader.setMat4fv("modelMatrix", modelMatrix);
-
-			//Draw floors
-			floor.Draw(surfaceShader);
-
-			//Set offset for this cell
-			size_t offset = ((sizeof(uint8_t) * mazeSizeX * it->second) + (sizeof(uint8_t) * it->first));
-			uint8_t *thisCell = mazeData + offset;
-			//Data on surrounding cells
-			uint8_t northCell, eastCell, southCell, westCell;
-			//If this cell is within range, return its data, else return 0
-			//Cell to the north: check Y
-			if (it->second > 0)
-			{
-				northCell = *(mazeData + (offset - sizeof(uint8_t) * mazeSizeX));
-			}
-			else
+			//Once generation is complete the number of changes is known, and they are replayed at a steady
+			//rate. The game can start as soon as the maze is complete, which skips the rest of the replay
+			generationComplete = maze.isGenerationComplete();
+			if (generationComplete && replayChangesPerTick == 0)
 			{
-				northCell = CELL_NULL;
+				replayChangesPerTick = std::max((size_t)(maze.getSequence() / (replayTimeSecs * tickRate)), (size_t)1);
+				if (farthest)
+				{
+					MazeMetrics metrics = maze.getMetrics();
+					std::cout << "Route from start to win: " << metrics.routeLength << " cells, " << metrics.routeJunctions
+						<< " junctions, branching factor " << metrics.branchingFactor << std::endl;
+				}
 			}
-			//Cell to the east: check X
-			if (it->first < mazeSizeX - 1)
+			//Starting the game skips the rest of the replay, and the finished maze is baked at once rather
+			//than by applying every remaining change
+			if (camMode == camWalk && generationComplete && mazeSequence < maze.getSequence())
 			{
-				eastCell = *(mazeData + (offset + sizeof(uint8_t)));
+				mazeSequence = maze.getSequence();
 			}
-			else
+			size_t maxChanges = replayChangesPerTick;
+			//Copy only the next changes in the log, or the whole maze if the log could not hold them all.
+			//Neither side waits on the other, so the generator never stalls. The cells cannot be copied while
+			//they are being written, so should the log overflow, the maze is left as it is until generation ends
+			mazeChanges.clear();
+			while (maxChanges > 0 && !maze.getChangesSince(mazeSequence, mazeChanges, maxChanges) && generationComplete)
 			{
-				eastCell = CELL_NULL;
+				mazeSequence = maze.copyMaze(mazeData);
+				resyncMaze = true;
 			}
-			//Cell to the south: check Y
-			if (it->second < mazeSizeY - 1)
+			//Show how much of the baked maze the camera can see
+			if (mazeMesh)
 			{
-				southCell = *(mazeData + (offset + sizeof(uint8_t) * mazeSizeX));
+				std::string title = "Maze Game - chunks drawn: " + std::to_string(mazeMesh->getNumChunksDrawn()) +
+					", culled: " + std::to_string(mazeMesh->getNumChunksCulled()) + ", hidden: " + std::to_string(mazeMesh->getNumChunksHidden());
+				glfwSetWindowTitle(window, title.c_str());
 			}
-			else
-			{
-				southCell = CELL_NULL;
-			}
-			//Cell to the west: check X
-			if (it->first > 0)
-			{
-				westCell = *(mazeData + (offset - sizeof(uint8_t)));
-			}
-			else
-			{
-				westCell = CELL_NULL;
-			}
-
-			//Check each cell wall to see if it should be rendered
-			if (!((*thisCell & CELL_PATH_N) || (northCell & CELL_PATH_S)))
-			{
-				//Draw north wall
-				modelMatrix = glm::mat4(1.0f);
-
-				modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 0.0f, offsetY - cellSize * scaleFactor / 2));
-				modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-				modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
-
-				surfaceShader.setMat4fv("modelMatrix", modelMatrix);
-
-				wall.Draw(surfaceShader);
-			}
-			if (!((*thisCell & CELL_PATH_E) || (eastCell & CELL_PATH_W)))
-			{
-				//Draw east wall
-				modelMatrix = glm::mat4(1.0f);
-
-				modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX + cellSize * scaleFactor / 2, 0.0f, offsetY));
-				modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
-
-				surfaceShader.setMat4fv("modelMatrix", modelMatrix);
-
-				wall.Draw(surfaceShader);
-			}
-			if (!((*thisCell & CELL_PATH_S) || (southCell & CELL_PATH_N)))
+			startTime = currentTime;
+		}
+		//Only changed cells can have changed walls, as a cell's walls are evaluated from both sides.
+		//After a full copy every cell is re-evaluated, with the walls found a row at a time
+		if (resyncMaze)
+		{
+			for (size_t y = 0; y < mazeSizeY; y++)
 			{
-				//Draw south wall
-				modelMatrix = glm::mat4(1.0f);
-
-				modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 0.0f, offsetY + cellSize * scaleFactor / 2));
-				modelMatrix = glm::rotate(modelMatrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-				modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
-
-				surfaceShader.setMat4fv("modelMatrix", modelMatrix);
-
-				wall.Draw(surfaceShader);
+				const uint8_t* row = mazeData + y * mazeSizeX;
+				MazeScan::getRowWalls(y > 0 ? row - mazeSizeX : NULL, row, y < mazeSizeY - 1 ? row + mazeSizeX : NULL, mazeSizeX, rowWalls.data());
+				for (size_t x = 0; x < mazeSizeX; x++)
+				{
+					setCellInstances(x, y, row[x], rowWalls[x], mazeSizeX, mazeSizeY, floorInstances, wallInstances);
+				}
 			}
-			if (!((*thisCell & CELL_PATH_W) || (westCell & CELL_PATH_E)))
-			{
-				//Draw west wall
-				modelMatrix = glm::mat4(1.0f);
-
-				modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX - cellSize * scaleFactor / 2, 0.0f, offsetY));
-				modelMatrix = glm::scale(modelMatrix, glm::vec3(0.25f));
-
-				surfaceShader.setMat4fv("modelMatrix", modelMatrix);
+			resyncMaze = false;
+		}
+		for (size_t i = 0; i < mazeChanges.size(); i++)
+		{
+			mazeData[mazeChanges[i].cellIndex] = mazeChanges[i].cell;
+		}
+		for (size_t i = 0; i < mazeChanges.size(); i++)
+		{
+			size_t cellIndex = mazeChanges[i].cellIndex;
+			updateCellInstances(cellIndex % mazeSizeX, cellIndex / mazeSizeX, mazeData, mazeSizeX, mazeSizeY, floorInstances, wallInstances);
+		}
+		mazeChanges.clear();
 
-				wall.Draw(surfaceShader);
-			}
+		//Once every change has been shown the maze never changes again, so it is baked into one static mesh
+		if (!mazeMesh && generationComplete && mazeSequence >= maze.getSequence())
+		{
+			CompactMaze compactMaze(&maze);
+			mazeMesh.reset(new MazeMesh(compactMaze, cellSize * scaleFactor, wallHeight, wallThickness,
+				floor.getTextureId("texture_diffuse"), wall.getTextureId("texture_diffuse")));
+			//Walls are thicker than the near plane is far, so this is as close as the camera can be to seeing past one
+			mazeVisibility.reset(new MazeVisibility(compactMaze, wallThickness / (cellSize * scaleFactor)));
+			std::cout << "Baked " << mazeMesh->getNumWalls() << " walls into " << mazeMesh->getNumWallRuns() << " runs, "
+				<< mazeMesh->getNumTriangles() << " triangles in " << mazeMesh->getChunks().size() << " chunks" << std::endl;
 		}
+		if (mazeMesh)
+		{
+			//Walking, the camera is below the tops of the walls, so only cells in sight through the passages around it
+			//are drawn. It can walk through walls and out of the maze, when everything in the frustum is drawn instead
+			std::pair<float, float> cameraCell = worldSpaceToCellSpace(cameraPosition.x, cameraPosition.z);
+			bool walking = camMode == camWalk && cameraPosition.y < wallHeight &&
+				mazeVisibility->findVisibleCells(glm::vec2(cameraCell.first, cameraCell.second));
+			mazeMesh->Draw(surfaceShader, projectionMatrix * viewMatrix, walking ? &mazeVisibility->getVisibleCells() : NULL);
+		}
+		else
+		{
+			//Draw every floor and wall from the instance buffers
+			size_t floorBase = floorInstances.beginFrame();
+			size_t wallBase = wallInstances.beginFrame();
+			floor.DrawInstanced(surfaceShader, floorInstances.getCount(), floorBase);
+			wall.DrawInstanced(surfaceShader, wallInstances.getCount(), wallBase);
+			floorInstances.endFrame();
+			wallInstances.endFrame();
+		}
+
 		//If the maze has been generated, show the win and lose locations
 		if (generationComplete)
 		{
@@ -680,7 +642,7 @@ int main(int argc, char** argv)
 			modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 1.0f, offsetY));
 			modelMatrix = glm::scale(modelMatrix, glm::vec3(2.0f));
 
-			surfaceShader.setMat4fv("modelMatrix", modelMatrix);
+			modelMatrixUniform.set(modelMatrix);
 
 			startCube.Draw(surfaceShader);
 
@@ -694,21 +656,23 @@ int main(int argc, char** argv)
 			modelMatrix = glm::translate(modelMatrix, glm::vec3(offsetX, 1.0f, offsetY));
 			modelMatrix = glm::scale(modelMatrix, glm::vec3(2.0f));
 
-			surfaceShader.setMat4fv("modelMatrix", modelMatrix);
+			modelMatrixUniform.set(modelMatrix);
 
 			winCube.Draw(surfaceShader);
 
-			startX = maze.getStartCell().first;
-			startY = maze.getStartCell().second;
+			startX = (int)maze.getStartCell().first;
+			startY = (int)maze.getStartCell().second;
 		}
 		//Check the current location to see if the player has won
 		std::pair<int, int> locationCell = worldSpaceToCellLocation(cameraPosition.x, cameraPosition.z);
-		if ((camMode == camWalk) && (maze.getWinCell().first == locationCell.first && maze.getWinCell().second == locationCell.second))
+		if ((camMode == camWalk) && ((int)maze.getWinCell().first == locationCell.first && (int)maze.getWinCell().second == locationCell.second))
 		{
 			std::cout << "You win!!! Press any key to quit" << std::endl;;
 			glfwSetWindowShouldClose(window, true);
 		}
 
+		frameUniforms.endFrame();
+
 		processInput(window);
 
 		glfwSwapBuffers(window);
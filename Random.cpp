@@ -0,0 +1,74 @@
+#include "Random.h"
+
+uint64_t Random::rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+Random::Random(uint64_t seed)
+{
+	Random::seed = seed;
+	//Expand the seed with splitmix64, which guarantees the state is never all zero
+	uint64_t splitState = seed;
+	for (int i = 0; i < 4; i++)
+	{
+		uint64_t z = (splitState += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		state[i] = z ^ (z >> 31);
+	}
+}
+
+uint64_t Random::next()
+{
+	uint64_t result = rotl(state[1] * 5, 7) * 9;
+	uint64_t t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+
+	return result;
+}
+
+uint64_t Random::nextBelow(uint64_t bound)
+{
+	if (bound <= 0xFFFFFFFFULL)
+	{
+		//Lemire's multiply and shift, only rejecting in the rare biased case
+		uint64_t product = (next() >> 32) * bound;
+		uint32_t low = (uint32_t)product;
+		if (low < bound)
+		{
+			uint32_t threshold = (uint32_t)((0x100000000ULL - bound) % bound);
+			while (low < threshold)
+			{
+				product = (next() >> 32) * bound;
+				low = (uint32_t)product;
+			}
+		}
+		return product >> 32;
+	}
+	//Bounds beyond 32 bits are rare, use masked rejection
+	uint64_t mask = bound - 1;
+	mask |= mask >> 1;
+	mask |= mask >> 2;
+	mask |= mask >> 4;
+	mask |= mask >> 8;
+	mask |= mask >> 16;
+	mask |= mask >> 32;
+	uint64_t value = next() & mask;
+	while (value >= bound)
+	{
+		value = next() & mask;
+	}
+	return value;
+}
+
+uint64_t Random::getSeed()
+{
+	return seed;
+}
@@ -0,0 +1,24 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+//Seedable xoshiro256** generator. Each generator owns its own state, so several can run concurrently
+//and the same seed always produces the same sequence
+class Random
+{
+private:
+	uint64_t seed;
+	uint64_t state[4];
+
+	static uint64_t rotl(uint64_t x, int k);
+public:
+	Random(uint64_t seed);
+
+	uint64_t next();
+	//Uniformly distributed in [0, bound), without modulo bias
+	uint64_t nextBelow(uint64_t bound);
+	uint64_t getSeed();
+};
+
+#endif
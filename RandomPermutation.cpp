@@ -0,0 +1,51 @@
+#include "RandomPermutation.h"
+#include "Random.h"
+
+const int RandomPermutation::NUM_ROUNDS;
+
+RandomPermutation::RandomPermutation(uint64_t size, uint64_t seed)
+{
+	RandomPermutation::size = size;
+	//The network shuffles a power of 4 at least as large as size, split into two equal halves
+	halfBits = 1;
+	while (halfBits < 32 && (1ULL << (2 * halfBits)) < size)
+	{
+		halfBits++;
+	}
+	halfMask = (1ULL << halfBits) - 1;
+	Random random(seed);
+	for (int i = 0; i < NUM_ROUNDS; i++)
+	{
+		keys[i] = random.next();
+	}
+}
+
+uint64_t RandomPermutation::encrypt(uint64_t value)
+{
+	uint64_t left = value >> halfBits;
+	uint64_t right = value & halfMask;
+	for (int i = 0; i < NUM_ROUNDS; i++)
+	{
+		//Round function is the splitmix64 finaliser
+		uint64_t z = right ^ keys[i];
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z ^= z >> 31;
+		uint64_t nextRight = left ^ (z & halfMask);
+		left = right;
+		right = nextRight;
+	}
+	return (left << halfBits) | right;
+}
+
+uint64_t RandomPermutation::get(uint64_t index)
+{
+	//Values outside the range are encrypted again until they land inside it, which keeps the mapping a
+	//permutation. The domain is less than four times size, so this takes a few steps at most on average
+	uint64_t value = encrypt(index);
+	while (value >= size)
+	{
+		value = encrypt(value);
+	}
+	return value;
+}
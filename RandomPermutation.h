@@ -0,0 +1,26 @@
+#ifndef RANDOM_PERMUTATION_H
+#define RANDOM_PERMUTATION_H
+
+#include <cstdint>
+
+//A seeded shuffle of the numbers 0 to size - 1, computed one position at a time with a small Feistel
+//network, so a shuffled list never has to be stored. The same seed always gives the same order
+class RandomPermutation
+{
+private:
+	static const int NUM_ROUNDS = 4;
+
+	uint64_t size;
+	int halfBits;
+	uint64_t halfMask;
+	uint64_t keys[NUM_ROUNDS];
+
+	uint64_t encrypt(uint64_t value);
+public:
+	RandomPermutation(uint64_t size, uint64_t seed);
+
+	//The number at the given position of the shuffled order, for positions 0 to size - 1
+	uint64_t get(uint64_t index);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include <glm/gtc/type_ptr.hpp>
 
 bool Shader::checkShaderCompileError(GLuint shaderPtr)
@@ -83,6 +84,40 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 	//Clean up shaders, they are now contained in the program
 	glDeleteShader(vertexShaderPtr);
 	glDeleteShader(fragmentShaderPtr);
+
+	reflectUniforms();
+}
+
+//Records the location of every active uniform, so none has to be looked up by the driver again. Members of
+//structs and arrays of structs are listed one by one, while arrays of basic types are listed once as "name[0]"
+//with their length, so each of their elements is located here, and the array is also recorded as "name"
+void Shader::reflectUniforms()
+{
+	GLint numUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &numUniforms);
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	std::vector<GLchar> nameBuffer(maxNameLength + 1, 0);
+	for (GLint i = 0; i < numUniforms; i++)
+	{
+		GLsizei nameLength = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(programId, (GLuint)i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+		std::string name(nameBuffer.data(), nameLength);
+		GLint location = glGetUniformLocation(programId, name.c_str());
+		uniformLocations[name] = location;
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+		{
+			std::string arrayName = name.substr(0, name.size() - 3);
+			uniformLocations[arrayName] = location;
+			for (GLint element = 1; element < size; element++)
+			{
+				std::string elementName = arrayName + "[" + std::to_string(element) + "]";
+				uniformLocations[elementName] = glGetUniformLocation(programId, elementName.c_str());
+			}
+		}
+	}
 }
 
 void Shader::use()
@@ -95,27 +130,63 @@ GLuint Shader::getProgramId()
 	return programId;
 }
 
+GLint Shader::getUniformLocation(const std::string& name) const
+{
+	std::unordered_map<std::string, GLint>::const_iterator found = uniformLocations.find(name);
+	return found != uniformLocations.end() ? found->second : -1;
+}
+
 void Shader::setBool(const std::string& name, bool value) const
 {
-	glUniform1i(glGetUniformLocation(programId, name.c_str()), (int)value);
+	glUniform1i(getUniformLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string& name, int value) const
 {
-	glUniform1i(glGetUniformLocation(programId, name.c_str()), value);
+	glUniform1i(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const
 {
-	glUniform1f(glGetUniformLocation(programId, name.c_str()), value);
+	glUniform1f(getUniformLocation(name), value);
 }
 
 void Shader::setVec3fv(const std::string& name, glm::vec3 vector) const
 {
-	glUniform3fv(glGetUniformLocation(programId, name.c_str()), 1, glm::value_ptr(vector));
+	glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(vector));
 }
 
 void Shader::setMat4fv(const std::string& name, glm::mat4 matrix) const
 {
-	glUniformMatrix4fv(glGetUniformLocation(programId, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+	glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+template <>
+void Uniform<bool>::set(const bool& value) const
+{
+	glUniform1i(location, (int)value);
+}
+
+template <>
+void Uniform<int>::set(const int& value) const
+{
+	glUniform1i(location, value);
+}
+
+template <>
+void Uniform<float>::set(const float& value) const
+{
+	glUniform1f(location, value);
+}
+
+template <>
+void Uniform<glm::vec3>::set(const glm::vec3& value) const
+{
+	glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+template <>
+void Uniform<glm::mat4>::set(const glm::mat4& value) const
+{
+	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
 }
\ No newline at end of file
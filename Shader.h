@@ -4,13 +4,37 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
+#include <unordered_map>
+
+//A uniform of type T, located once when it is looked up, so setting it is a single glUniform call on the program
+//in use. Uniforms the program does not have, or which were optimised away, have location -1, which glUniform ignores
+template <typename T>
+class Uniform
+{
+private:
+	GLint location;
+public:
+	Uniform() : location(-1) {}
+	explicit Uniform(GLint location) : location(location) {}
+	void set(const T& value) const;
+	GLint getLocation() const { return location; }
+};
+
+template <> void Uniform<bool>::set(const bool& value) const;
+template <> void Uniform<int>::set(const int& value) const;
+template <> void Uniform<float>::set(const float& value) const;
+template <> void Uniform<glm::vec3>::set(const glm::vec3& value) const;
+template <> void Uniform<glm::mat4>::set(const glm::mat4& value) const;
 
 class Shader
 {
 private:
 	GLuint programId;
+	//Location of every active uniform, read once the program is linked
+	std::unordered_map<std::string, GLint> uniformLocations;
 
 	bool checkShaderCompileError(GLuint shaderPtr);
+	void reflectUniforms();
 
 public:
 	Shader(const char* vertexPath, const char* fragmentPath);
@@ -19,7 +43,15 @@ public:
 	
 	//Provide program id read access
 	GLuint getProgramId();
-	//For setting uniforms within a shader
+	//Location of a uniform from the table built at link time, without asking the driver. -1 if there is no such uniform
+	GLint getUniformLocation(const std::string& name) const;
+	//A handle for setting a uniform repeatedly, for uniforms set every frame or every draw
+	template <typename T>
+	Uniform<T> getUniform(const std::string& name) const
+	{
+		return Uniform<T>(getUniformLocation(name));
+	}
+	//For setting uniforms within a shader by name, for uniforms set once or rarely
 	void setBool(const std::string &name, bool value) const;
 	void setInt(const std::string &name, int value) const;
 	void setFloat(const std::string& name, float value) const;
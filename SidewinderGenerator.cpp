@@ -0,0 +1,36 @@
+#include "SidewinderGenerator.h"
+
+std::string SidewinderGenerator::getName()
+{
+	return "sidewinder";
+}
+
+void SidewinderGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	//The top row cannot go north, so it is a single corridor
+	for (size_t x = 0; x + 1 < sizeX; x++)
+	{
+		carvePassage(maze, x, 0, 1);
+		step(maze, x, 0);
+	}
+	for (size_t y = 1; y < sizeY; y++)
+	{
+		size_t runStart = 0;
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			if (x == sizeX - 1 || (random.next() & 1))
+			{
+				//Close the run with a passage north from one of its cells
+				carvePassage(maze, runStart + random.nextBelow(x - runStart + 1), y, 0);
+				runStart = x + 1;
+			}
+			else
+			{
+				carvePassage(maze, x, y, 1);
+			}
+			step(maze, x, y);
+		}
+	}
+}
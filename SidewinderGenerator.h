@@ -0,0 +1,16 @@
+#ifndef SIDEWINDER_GENERATOR_H
+#define SIDEWINDER_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Sidewinder: carves east along each row in runs, closing each run with one passage north.
+//Needs no memory, the top row is always one open corridor
+class SidewinderGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "TiledGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "DisjointSet.h"
+
+const size_t TiledGenerator::MAX_TILE_SIZE;
+const size_t TiledGenerator::MIN_TILES;
+
+TiledGenerator::TiledGenerator(const std::string& tileAlgorithm, unsigned int numThreads)
+{
+	TiledGenerator::tileAlgorithm = tileAlgorithm;
+	TiledGenerator::numThreads = numThreads > 0 ? numThreads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+std::string TiledGenerator::getName()
+{
+	return "tiled";
+}
+
+void TiledGenerator::carveTile(MazeGenerator* tileGenerator, uint8_t* cells, Maze* maze, size_t tileX, size_t tileY, size_t tileSize, uint64_t seed)
+{
+	size_t startX = tileX * tileSize;
+	size_t startY = tileY * tileSize;
+	size_t sizeX = std::min(tileSize, maze->getSizeX() - startX);
+	size_t sizeY = std::min(tileSize, maze->getSizeY() - startY);
+	//Each tile is generated into a small maze of its own, then copied into place. No two tiles
+	//share a cell, so the workers never write to the same memory
+	Maze tile(sizeX, sizeY, NO_TRACKING);
+	if (sizeX * sizeY == 1)
+	{
+		tile.setCell(0, 0, CELL_VISITED);
+	}
+	else
+	{
+		Random random(seed);
+		tileGenerator->carve(&tile, random);
+	}
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			cells[maze->getCellIndex(startX + x, startY + y)] = tile.getCell(x, y);
+		}
+	}
+}
+
+void TiledGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	//Shrink the tiles until there are enough to share between threads. This depends on the maze size
+	//alone, so the same seed gives the same maze whatever the thread count
+	size_t tileSize = MAX_TILE_SIZE;
+	while (tileSize > 16 && ((sizeX + tileSize - 1) / tileSize) * ((sizeY + tileSize - 1) / tileSize) < MIN_TILES)
+	{
+		tileSize /= 2;
+	}
+	size_t numTilesX = (sizeX + tileSize - 1) / tileSize;
+	size_t numTilesY = (sizeY + tileSize - 1) / tileSize;
+	size_t numTiles = numTilesX * numTilesY;
+
+	//Seeds are drawn up front, so the maze depends only on the seed and not on how tiles land on threads
+	std::vector<uint64_t> tileSeeds(numTiles);
+	for (size_t i = 0; i < numTiles; i++)
+	{
+		tileSeeds[i] = random.next();
+	}
+
+	//The event log only accepts one writer, so when changes are tracked the workers fill a scratch
+	//copy which is published afterwards. Otherwise they write straight into the maze
+	std::vector<uint8_t> scratch;
+	uint8_t* cells = maze->getMaze();
+	if (maze->isTrackingChanges())
+	{
+		scratch.assign(maze->getMazeLength(), CELL_NULL);
+		cells = scratch.data();
+	}
+
+	std::atomic<size_t> nextTile(0);
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < std::min((size_t)numThreads, numTiles); i++)
+	{
+		workers.push_back(std::thread([&]()
+		{
+			std::unique_ptr<MazeGenerator> tileGenerator(MazeGenerator::create(tileAlgorithm));
+			for (size_t tile = nextTile++; tile < numTiles; tile = nextTile++)
+			{
+				carveTile(tileGenerator.get(), cells, maze, tile % numTilesX, tile / numTilesX, tileSize, tileSeeds[tile]);
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	//Every border between two neighbouring tiles, as (tile number << 1) | 1 for the border to its east,
+	//or << 1 alone for the border to its south. Joining tiles across a random spanning tree of these
+	//borders, with one passage each, keeps exactly one route between any two cells
+	std::vector<size_t> borders;
+	for (size_t tileY = 0; tileY < numTilesY; tileY++)
+	{
+		for (size_t tileX = 0; tileX < numTilesX; tileX++)
+		{
+			size_t tile = tileY * numTilesX + tileX;
+			if (tileX < numTilesX - 1)
+			{
+				borders.push_back((tile << 1) | 1);
+			}
+			if (tileY < numTilesY - 1)
+			{
+				borders.push_back(tile << 1);
+			}
+		}
+	}
+	for (size_t i = borders.size(); i > 1; i--)
+	{
+		std::swap(borders[i - 1], borders[random.nextBelow(i)]);
+	}
+	DisjointSet tiles(numTiles);
+	for (size_t i = 0; i < borders.size(); i++)
+	{
+		size_t tile = borders[i] >> 1;
+		bool east = (borders[i] & 1) != 0;
+		if (!tiles.join(tile, east ? tile + 1 : tile + numTilesX))
+		{
+			continue;
+		}
+		size_t startX = (tile % numTilesX) * tileSize;
+		size_t startY = (tile / numTilesX) * tileSize;
+		if (east)
+		{
+			size_t x = startX + tileSize - 1;
+			size_t y = startY + random.nextBelow(std::min(tileSize, sizeY - startY));
+			cells[maze->getCellIndex(x, y)] |= CELL_PATH_E;
+		}
+		else
+		{
+			size_t x = startX + random.nextBelow(std::min(tileSize, sizeX - startX));
+			size_t y = startY + tileSize - 1;
+			cells[maze->getCellIndex(x, y)] |= CELL_PATH_S;
+		}
+	}
+
+	if (maze->isTrackingChanges())
+	{
+		for (size_t y = 0; y < sizeY; y++)
+		{
+			for (size_t x = 0; x < sizeX; x++)
+			{
+				maze->addCellLocation(std::pair<size_t, size_t>(x, y));
+				maze->setCell(x, y, cells[maze->getCellIndex(x, y)]);
+				step(maze, x, y);
+			}
+		}
+	}
+}
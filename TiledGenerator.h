@@ -0,0 +1,29 @@
+#ifndef TILED_GENERATOR_H
+#define TILED_GENERATOR_H
+
+#include <string>
+#include "MazeGenerator.h"
+
+//Splits the maze into square tiles and generates a maze inside each tile on a pool of worker threads, using
+//any of the other engines. The tiles are then joined by one passage per tile in a random spanning tree,
+//chosen with a union-find pass over the tile borders, so the result is still a perfect maze
+class TiledGenerator : public MazeGenerator
+{
+private:
+	static const size_t MAX_TILE_SIZE = 256;
+	static const size_t MIN_TILES = 64;
+
+	std::string tileAlgorithm;
+	unsigned int numThreads;
+
+	void carveTile(MazeGenerator* tileGenerator, uint8_t* cells, Maze* maze, size_t tileX, size_t tileY, size_t tileSize, uint64_t seed);
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	//A thread count of 0 uses one thread per hardware thread
+	TiledGenerator(const std::string& tileAlgorithm = "backtracker", unsigned int numThreads = 0);
+
+	std::string getName();
+};
+
+#endif
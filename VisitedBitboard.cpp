@@ -0,0 +1,57 @@
+#include "VisitedBitboard.h"
+
+VisitedBitboard::VisitedBitboard(size_t sizeX, size_t sizeY)
+{
+	stride = sizeX + 2;
+	size_t numBits = stride * (sizeY + 2);
+	words.assign((numBits + 63) / 64, 0);
+
+	//Mark the border as visited so the generator never tries to leave the maze
+	for (size_t x = 0; x < stride; x++)
+	{
+		size_t top = x;
+		size_t bottom = (sizeY + 1) * stride + x;
+		words[top >> 6] |= 1ULL << (top & 63);
+		words[bottom >> 6] |= 1ULL << (bottom & 63);
+	}
+	for (size_t y = 1; y <= sizeY; y++)
+	{
+		size_t left = y * stride;
+		size_t right = y * stride + sizeX + 1;
+		words[left >> 6] |= 1ULL << (left & 63);
+		words[right >> 6] |= 1ULL << (right & 63);
+	}
+}
+
+size_t VisitedBitboard::getBitIndex(size_t x, size_t y)
+{
+	return (y + 1) * stride + (x + 1);
+}
+
+uint64_t VisitedBitboard::getBit(size_t bit)
+{
+	return (words[bit >> 6] >> (bit & 63)) & 1;
+}
+
+void VisitedBitboard::setVisited(size_t x, size_t y)
+{
+	size_t bit = getBitIndex(x, y);
+	words[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+bool VisitedBitboard::isVisited(size_t x, size_t y)
+{
+	return getBit(getBitIndex(x, y)) != 0;
+}
+
+uint8_t VisitedBitboard::getUnvisitedNeighbours(size_t x, size_t y)
+{
+	size_t bit = getBitIndex(x, y);
+	uint64_t visited = getBit(bit - stride) | (getBit(bit + 1) << 1) | (getBit(bit + stride) << 2) | (getBit(bit - 1) << 3);
+	return (uint8_t)(~visited & 0x0F);
+}
+
+size_t VisitedBitboard::getMemoryUsage()
+{
+	return words.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,28 @@
+#ifndef VISITED_BITBOARD_H
+#define VISITED_BITBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//One bit per cell recording whether it has been visited. The grid is surrounded by a border of
+//permanently visited cells, so neighbour tests need no bounds checks
+class VisitedBitboard
+{
+private:
+	size_t stride;
+	std::vector<uint64_t> words;
+
+	size_t getBitIndex(size_t x, size_t y);
+	uint64_t getBit(size_t bit);
+public:
+	VisitedBitboard(size_t sizeX, size_t sizeY);
+
+	void setVisited(size_t x, size_t y);
+	bool isVisited(size_t x, size_t y);
+	//Mask of the unvisited neighbours of a cell, with bit d set for direction d (0 to 3 for N, E, S & W)
+	uint8_t getUnvisitedNeighbours(size_t x, size_t y);
+	size_t getMemoryUsage();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "WilsonGenerator.h"
+#include "VisitedBitboard.h"
+
+std::string WilsonGenerator::getName()
+{
+	return "wilson";
+}
+
+void WilsonGenerator::carve(Maze* maze, Random& random)
+{
+	size_t sizeX = maze->getSizeX();
+	size_t sizeY = maze->getSizeY();
+	VisitedBitboard inMaze(sizeX, sizeY);
+	//The direction the current walk last left each cell by. When a walk crosses its own path the
+	//old direction is overwritten, which erases the loop without having to track it
+	std::vector<uint8_t> walkDirections(sizeX * sizeY);
+
+	size_t firstX = random.nextBelow(sizeX);
+	size_t firstY = random.nextBelow(sizeY);
+	maze->addCellLocation(std::pair<size_t, size_t>(firstX, firstY));
+	maze->setCell(firstX, firstY, CELL_VISITED);
+	inMaze.setVisited(firstX, firstY);
+
+	for (size_t y = 0; y < sizeY; y++)
+	{
+		for (size_t x = 0; x < sizeX; x++)
+		{
+			if (inMaze.isVisited(x, y))
+			{
+				continue;
+			}
+			//Walk randomly from this cell until the maze is reached
+			size_t currentX = x;
+			size_t currentY = y;
+			while (!inMaze.isVisited(currentX, currentY))
+			{
+				uint8_t direction = chooseRoute(getNeighbourMask(currentX, currentY, sizeX, sizeY), random);
+				walkDirections[currentY * sizeX + currentX] = direction;
+				currentX += DIRECTION_X[direction];
+				currentY += DIRECTION_Y[direction];
+			}
+			//Retrace the loop-erased walk, adding it to the maze
+			currentX = x;
+			currentY = y;
+			while (!inMaze.isVisited(currentX, currentY))
+			{
+				uint8_t direction = walkDirections[currentY * sizeX + currentX];
+				carvePassage(maze, currentX, currentY, direction);
+				inMaze.setVisited(currentX, currentY);
+				step(maze, currentX, currentY);
+				currentX += DIRECTION_X[direction];
+				currentY += DIRECTION_Y[direction];
+			}
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef WILSON_GENERATOR_H
+#define WILSON_GENERATOR_H
+
+#include "MazeGenerator.h"
+
+//Wilson's algorithm: joins each cell with a loop-erased random walk that ends on the maze so far.
+//Slow to start, but picks uniformly from every possible maze
+class WilsonGenerator : public MazeGenerator
+{
+protected:
+	void carve(Maze* maze, Random& random);
+public:
+	std::string getName();
+};
+
+#endif
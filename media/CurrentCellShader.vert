@@ -1,9 +1,15 @@
 #version 450 core
 layout(location = 0) in vec3 aPos;		//positions
 
+//Per-frame camera, shared by every shader and filled by FrameUniforms
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec3 viewPosition;
+};
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
 
 void main()
 {
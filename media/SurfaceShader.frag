@@ -16,16 +16,15 @@ struct DirectionalLight
 	vec3 specular;
 };
 
+//The attenuation terms sit after the vec3s, where std140 packs them, to match PointLightUniforms
 struct PointLight
 {
 	vec3 position;
-
 	float constant;
-	float linear;
-	float quadratic;
-
 	vec3 ambient;
+	float linear;
 	vec3 diffuse;
+	float quadratic;
 	vec3 specular;
 };
 
@@ -34,27 +33,51 @@ struct PointLight
 in vec3 fragPosition;
 in vec3 normal;
 in vec2 textureCoords;
+flat in int surface;
 
 out vec4 FragColor;
 
-uniform vec3 viewPosition;
+//Per-frame camera and lighting, shared by every shader and filled by FrameUniforms
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec3 viewPosition;
+};
+
+layout(std140, binding = 1) uniform Lighting
+{
+	DirectionalLight directionalLight;
+	PointLight pointLights[MAX_POINT_LIGHTS];
+	int numPointLights;
+};
+
 uniform Material material;
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform int numPointLights = 0;
+//Baked mazes draw floors and walls together, with the walls textured from here
+uniform sampler2D wallMap;
+
+vec3 diffuseColour()
+{
+	return vec3(surface == 1 ? texture(wallMap, textureCoords) : texture(material.diffuseMap, textureCoords));
+}
+
+vec3 specularColour()
+{
+	return vec3(surface == 1 ? texture(wallMap, textureCoords) : texture(material.specularMap, textureCoords));
+}
 
 vec3 calcDirectionalLight(DirectionalLight light, vec3 normalUnitV, vec3 viewDirection)
 {
 	vec3 lightDirection = normalize(-light.direction);
 	//Ambient
-	vec3 ambient = vec3(texture(material.diffuseMap, textureCoords)) * light.ambient;
+	vec3 ambient = diffuseColour() * light.ambient;
 	//Diffuse
 	float diffuseAmount = max(dot(normalUnitV, lightDirection), 0.0);
-	vec3 diffuse = diffuseAmount * vec3(texture(material.diffuseMap, textureCoords)) * light.diffuse;
+	vec3 diffuse = diffuseAmount * diffuseColour() * light.diffuse;
 	//Specular
 	vec3 reflectDirection = reflect(-lightDirection, normalUnitV);
 	float specularAmount = pow(max(dot(viewDirection, reflectDirection), 0.0), material.shininess);
-	vec3 specular = vec3(texture(material.specularMap, textureCoords)) * specularAmount * light.specular;
+	vec3 specular = specularColour() * specularAmount * light.specular;
 
 	return (ambient + diffuse + specular);
 }
@@ -63,14 +86,14 @@ vec3 calcPointLight(PointLight light, vec3 normalUnitV, vec3 fragPosition, vec3
 {
 	vec3 lightDirection = normalize(light.position - fragPosition);
 	//Ambient
-	vec3 ambient = vec3(texture(material.diffuseMap, textureCoords)) * light.ambient;
+	vec3 ambient = diffuseColour() * light.ambient;
 	//Diffuse
 	float diffuseAmount = max(dot(normalUnitV, lightDirection), 0.0);
-	vec3 diffuse = diffuseAmount * vec3(texture(material.diffuseMap, textureCoords)) * light.diffuse;
+	vec3 diffuse = diffuseAmount * diffuseColour() * light.diffuse;
 	//Specular
 	vec3 reflectDirection = reflect(-lightDirection, normalUnitV);
 	float specularAmount = pow(max(dot(viewDirection, reflectDirection), 0.0), material.shininess);
-	vec3 specular = vec3(texture(material.specularMap, textureCoords)) * specularAmount * light.specular;
+	vec3 specular = specularColour() * specularAmount * light.specular;
 	//Attenuation
 	float distance = length(light.position - fragPosition);
 	float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
@@ -2,20 +2,32 @@
 layout(location = 0) in vec3 aPosition;		//positions
 layout(location = 1) in vec3 aNormal;		//normal
 layout(location = 2) in vec2 aTextureCoords; //texture coordinates
+layout(location = 3) in mat4 aInstanceMatrix; //per-instance model matrix (locations 3-6)
+layout(location = 7) in float aSurface;		//0 for the material texture, 1 for wallMap, only set by baked mazes
 
 out vec3 fragPosition;
 out vec3 normal;
 out vec2 textureCoords;
+flat out int surface;
+
+//Per-frame camera, shared by every shader and filled by FrameUniforms
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec3 viewPosition;
+};
 
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
+uniform bool instanced = false;
 
 void main()
 {
-	fragPosition = vec3(modelMatrix * vec4(aPosition, 1.0));
-	normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
+	mat4 model = instanced ? aInstanceMatrix : modelMatrix;
+	fragPosition = vec3(model * vec4(aPosition, 1.0));
+	normal = mat3(transpose(inverse(model))) * aNormal;
 
 	gl_Position =  projectionMatrix * viewMatrix * vec4(fragPosition, 1.0);
 	textureCoords = aTextureCoords;
+	surface = int(aSurface + 0.5);
 };
\ No newline at end of file